@@ -35,7 +35,43 @@ MODE mode = MODE::NORMAL;
 // Must instantiate encoders and LCD
 RotaryEncoder aEncoder( A_ENCODER_A, A_ENCODER_B, A_ENCODER_SW);
 RotaryEncoder bEncoder( B_ENCODER_A, B_ENCODER_B, B_ENCODER_SW);
-LiquidCrystal_I2C lcd(0x27,20,2);  // set the lcd address to 0x27 for a 16 chars and 2 line display
+// Display geometry - any HD44780 display, e.g. 16 x 2, 20 x 4, 40 x 2
+#ifndef LCD_COLUMNS
+#define LCD_COLUMNS 16
+#endif
+#ifndef LCD_ROWS
+#define LCD_ROWS 2
+#endif
+LiquidCrystal_I2C lcd(0x27, LCD_COLUMNS, LCD_ROWS);  // set the lcd address to 0x27
+
+// Optionally, the menus can drive the display through the library's own PCF8574 transport, which sends
+// each run of characters as a single I2C transaction (far less bus time than LiquidCrystal_I2C, which
+// sends 6 transactions per character).  The Action below still draws with lcd - both can share the display.
+#ifndef USE_MENU_PCF8574_TRANSPORT
+#define USE_MENU_PCF8574_TRANSPORT 0
+#endif
+#if USE_MENU_PCF8574_TRANSPORT
+MenuPCF8574Transport menuDisplay(0x27);
+#endif
+
+// The settings are kept in flash, so they survive a power cycle, in a data partition of their own
+// named "menu".  The default partition table hasn't got one: put a partitions.csv like this (the
+// default table, with 16K taken from the end of the SPIFFS partition) in the sketch's folder.
+//
+//   # Name,   Type, SubType,  Offset,   Size,     Flags
+//   nvs,      data, nvs,      0x9000,   0x5000,
+//   otadata,  data, ota,      0xe000,   0x2000,
+//   app0,     app,  ota_0,    0x10000,  0x140000,
+//   app1,     app,  ota_1,    0x150000, 0x140000,
+//   spiffs,   data, spiffs,   0x290000, 0x15C000,
+//   menu,     data, 0x99,     0x3EC000, 0x4000,
+//   coredump, data, coredump, 0x3F0000, 0x10000,
+//
+// Don't be tempted to use the SPIFFS partition instead: the settings would overwrite whatever
+// is in it, and formatting it for a file system would wipe them.
+#if defined(ESP32)
+MenuPartitionStorage settingsStorage("menu");
+#endif
 
 /* Menu structure...
 
@@ -47,7 +83,7 @@ LiquidCrystal_I2C lcd(0x27,20,2);  // set the lcd address to 0x27 for a 16 chars
     |
     |--Speed             // MenuLongValue
     |
-    |--Width             // MenuSmallFloatValue
+    |--Width             // MenuFloatValue
     |
     |--Operation Mode    // MenuDropDownListValue
     |
@@ -55,9 +91,13 @@ LiquidCrystal_I2C lcd(0x27,20,2);  // set the lcd address to 0x27 for a 16 chars
     |
     |--Configuration     // Menu
         |
-        |--Brightness        // MenuRotaryListValue
+        |--Brightness        // MenuDropDownListValue
         |
         |--Volume            // MenuLongValue
+        |
+        |--Width             // (the same MenuFloatValue as above)
+        |
+        |--Wire Diameter     // MenuFixedValue
 */
 
 // Declare forward references
@@ -74,72 +114,116 @@ int colour = 0;
 // Vairables managed from "Config menu"
 int brightness = 2;
 long volume = 50;
+long wireDiameter = menuFixed(0.355, 3); // Held in thousandths of a mm (355)
+volatile int32_t wireMicrons = 0;        // ...and published as an int32, ready for stepper maths
+
+// Live values shown on the "Status" screen (normally updated by your stepper code)
+volatile long windings = 0;
 
 /********************************************************************************************************/
-// NOTE: ALL list values (lists of string pointers and lists or menu pointers) in DualEncoderMenuSystem
-// MUST be terminated with a nullptr - failure to do this will result in an application crash!
+// NOTE: This example declares its menus with MenuLabel/MenuOption, MENU_LIST and MENU_ITEMS, which the
+// compiler checks (labels too wide for the display, empty/null list entries), and which need no null
+// terminators, no heap and no start-up work.  The older form, with plain strings and null-terminated
+// lists, still works - but then ALL lists MUST be terminated with a nullptr, or your application will crash!
 /********************************************************************************************************/
 
 // Construct menu items ahead of the menu in which they appear (in the case, the "Main menu")
-MenuAction mmRun = MenuAction("Run App.", appFn, appInputFn);
-MenuBoolValue mmDirection = MenuBoolValue("Set Rotation", "C.W.", "C.C.W", &direction);
-MenuLongValue mmSpeed = MenuLongValue("Set Speed", "rpm", 0, 2000, 100, 10, &speed);
+MenuAction mmRun(MenuLabel("Run App."), appFn, appInputFn);
+MenuBoolValue mmDirection(MenuLabel("Set Rotation"), MenuOption("C.W."), MenuOption("C.C.W"), &direction);
+MenuLongValue mmSpeed(MenuLabel("Set Speed"), MenuLabel("rpm"), 0, 2000, 100, 10, &speed);
 // NOTE: The coarse and fine step settings for MenuFloatValue - encoder A makes coarse changes
 // to the value, while encoder B makes finer changes (or) they can be set to the same value)
-MenuFloatValue mmWidth = MenuFloatValue("Set Width", "mm", 0.001, 2.5, 0.1, 0.005, &width);
-MenuDropDownListValue mmOperationMode = MenuDropDownListValue(
-    "Select Mode",
-    (const char *[]){
-        "Automatic",
-        "Manual",
-        "Test",
-        "Once (only)",
-        0  // <-- Do NOT forget to null-terminate!
-    },
-    &operationMode);
-MenuRotaryListValue mmColour = MenuRotaryListValue(
-    "Colour",
-    (const char *[]){
-        "Set Red",
-        "Set Green",
-        "Set Blue",
-        "Set Orange",
-        "Set Purple",
-        "Set Cyan",
-        "Set Magenta",
-        0  // <-- Do NOT forget to null-terminate!
-    },
-    &colour);
+MenuFloatValue mmWidth(MenuLabel("Set Width"), MenuLabel("mm"), 0.001, 2.5, 0.1, 0.005, &width);
+MENU_LIST(operationModes,
+    "Automatic",
+    "Manual",
+    "Test",
+    "Once (only)");
+MenuDropDownListValue mmOperationMode("Select Mode", operationModes, &operationMode);
+MENU_LIST(colours,
+    "Set Red",
+    "Set Green",
+    "Set Blue",
+    "Set Orange",
+    "Set Purple",
+    "Set Cyan",
+    "Set Magenta");
+MenuRotaryListValue mmColour("Colour", colours, &colour);
 
 // Construct menu items ahead of the menu in which they appear (in the case, the "Configuration Menu")
-MenuLongValue cfgVolume = MenuLongValue("Set Volume", "%", 0, 100, 10, 1, &volume);                   // Do NOT forget to null terminate lists >|<
-MenuDropDownListValue cfgBrightness = MenuDropDownListValue("Set Brightness", (const char *[]){"Minimum", "Dim", "Medium", "Bright", "Maximum", 0}, &brightness);
+MenuLongValue cfgVolume(MenuLabel("Set Volume"), MenuLabel("%"), 0, 100, 10, 1, &volume);
+MENU_LIST(brightnessLevels, "Minimum", "Dim", "Medium", "Bright", "Maximum");
+MenuDropDownListValue cfgBrightness("Set Brightness", brightnessLevels, &brightness);
+// NOTE: MenuFixedValue limits and steps are given in the scaled units (here, 3 decimal places = microns),
+// so steps and limits are exact (no float rounding drift)
+MenuFixedValue cfgWireDiameter(MenuLabel("Wire Diameter"), MenuLabel("mm"), 3, menuFixed(0.05, 3), menuFixed(2.0, 3), 50, 1, &wireDiameter);
+// NOTE: A list needn't be held in RAM - these entries (AWG 13 to 40) are worked out as they're displayed,
+// from a count & a text function.  Choosing one sets the wire diameter.
+int wireGauge = 14; // (AWG 27)
+long awgMicrons(int index) { return lround(127 * pow(92, (36 - (13 + index)) / 39.0)); }
+int wireGaugeCount() { return 28; }
+void wireGaugeText(int index, char *text, size_t size)
+{
+    long microns = awgMicrons(index);
+    snprintf(text, size, "AWG %d %ld.%03ldmm", 13 + index, microns / 1000, microns % 1000);
+}
+MenuDropDownListValue cfgWireGauge(MenuLabel("Wire Gauge"), wireGaugeCount, wireGaugeText, &wireGauge);
 
-// Constuct the sub menu first, so it can be incorporated into it parent ("Main Menu")
-Menu cfgMnu = Menu(
-    "Configuration",
-    (MenuSystem *[]) {
-        &cfgBrightness,
-        &cfgVolume,
-        &mmWidth, // <-- NOTE: A single menu item can be used in more than one place - mmWidth appears in the both configuration and main menus
-        0  // <-- Do NOT forget to null-terminate!
+// NOTE: A menu's entries can be built as they're needed, too - here, one for each stored recipe.  Only the
+// entries on the display exist at any time, however many recipes there are.
+#define RECIPE_COUNT 12
+long recipeTurns[RECIPE_COUNT] = {100, 250, 400, 800, 1200, 1500, 2000, 2500, 3000, 4000, 5000, 6000};
+class RecipeMenuGenerator : public MenuItemGenerator
+{
+public:
+    int count() override { return RECIPE_COUNT; }
+    MenuSystem *build(int index, MenuItemSlot &slot) override
+    {
+        snprintf(slot.label, sizeof(slot.label), "Recipe %d", index + 1);
+        return slot.make<MenuLongValue>(slot.label, "turns", 0, 9999, 100, 1, &recipeTurns[index]);
     }
-);
+} recipeGenerator;
+MenuDynamic cfgRecipes(MenuLabel("Recipes"), &recipeGenerator);
+
+// Live values for the "Status" screen - each is sampled (at the rate given, in ms) only while it's on the
+// display, and redrawn only when it changes.  They can be read through a pointer or a function.
+long uptimeSeconds() { return millis() / 1000; }
+const char *operationModeName() { return operationModes[operationMode]; }
+MenuWatchLong stWindings(MenuLabel("Windings"), MenuLabel(""), &windings, 200);
+MenuWatchLong stSpeed(MenuLabel("Speed"), MenuLabel("rpm"), &speed, 200);
+MenuWatchFixed stWire(MenuLabel("Wire"), MenuLabel("mm"), 3, &wireDiameter, 200);
+MenuWatchText stMode(MenuLabel("Mode"), operationModeName, 200);
+MenuWatchLong stUptime(MenuLabel("Up Time"), MenuLabel("s"), uptimeSeconds, 1000);
+MENU_ITEMS(statusItems,
+    &stWindings,
+    &stSpeed,
+    &stWire,
+    &stMode,
+    &stUptime);
+MenuDashboard mmStatus("Status", statusItems);
+
+// Constuct the sub menu first, so it can be incorporated into it parent ("Main Menu")
+MENU_ITEMS(cfgItems,
+    &cfgBrightness,
+    &cfgVolume,
+    &mmWidth, // <-- NOTE: A single menu item can be used in more than one place - mmWidth appears in the both configuration and main menus
+    &cfgWireDiameter,
+    &cfgWireGauge,
+    &cfgRecipes);
+Menu cfgMnu("Configuration", cfgItems);
 
 // Now we can add the items we consturcted, above, into the main menu
-Menu mainMenu = Menu(
-    "Main Menu",
-    (MenuSystem *[]) {
-        &mmRun,
-        &mmDirection,
-        &cfgMnu,
-        &mmSpeed,
-        &mmWidth,
-        &mmOperationMode,
-        &mmColour,
-        0 // <-- Do NOT forget to null-terminate!
-    }
-);
+MENU_ITEMS(mainItems,
+    &mmRun,
+    &mmDirection,
+    &cfgMnu,
+    &mmSpeed,
+    &mmWidth,
+    &mmOperationMode,
+    &mmColour,
+    &stWindings, // <-- Live values can go straight into a menu, too
+    &mmStatus);
+Menu mainMenu("Main Menu", mainItems);
 
 // Initialise our TWO encoders
 void InitEncoders()
@@ -153,7 +237,7 @@ void InitEncoders()
 	bEncoder.begin();
 }
 
-// Custom LCD charcaters (see note, further down)
+// Custom LCD charcaters (see appReDraw())
 
 byte custChar1[] = {
     0b00100,
@@ -185,11 +269,32 @@ byte custChar3[] = {
     0b11011,
     0b00000};
 
+// Called (from MenuSystem::poll()) when the Set Speed or Set Width editor closes having changed its
+// value - so there's no need to keep checking speed & width in loop(), and the stepper is only
+// reconfigured when there's actually something to do.  (onChange() would tell us as the value
+// is turned, instead.)
+void stepperSettingsChanged(MenuSystem *item)
+{
+    Serial.print("Reconfigure stepper: ");
+    Serial.print(speed);
+    Serial.print(" rpm, ");
+    Serial.print(width, 3);
+    Serial.println(" mm");
+}
+
+void wireGaugeChosen(MenuSystem *item)
+{
+    wireDiameter = awgMicrons(wireGauge);
+    wireMicrons = wireDiameter;
+}
+
 // This menu item is only ever called from the app function
 int appOptionValue = 0;
-MenuDropDownListValue appOptions = MenuDropDownListValue("App. Options", (const char *[]){"Continue", "Pause", "Exit", 0}, &appOptionValue);
+MENU_LIST(appOptionList, "Continue", "Pause", "Exit");
+MenuDropDownListValue appOptions("App. Options", appOptionList, &appOptionValue);
 
 char appData[17];
+char appGlyphs[3]; // The characters which show custChar1-3 (see appReDraw())
 bool bRedraw = false;
 long lastAppAnimationTime = 0;
 
@@ -246,6 +351,13 @@ void appReDraw()
 {
     // Completely redraw the app output
     // (for example, after a menu was displayed)
+
+    // The custom characters used by the animation - the menu system loads them into free LCD
+    // slots (so they can't clash with its own), and tells us which characters to print
+    appGlyphs[0] = MenuSystem::glyph(custChar1);
+    appGlyphs[1] = MenuSystem::glyph(custChar2);
+    appGlyphs[2] = MenuSystem::glyph(custChar3);
+
     lcd.clear();
     lcd.setCursor(0, 0);
     if (mode == MODE::APP_RUNNING)
@@ -283,8 +395,11 @@ void appAnimate()
         c = random(4, 8);
         if (c == 4)
             c = 0x20;
+        else
+            c = appGlyphs[c - 5];
         appData[i] = c;
     }
+    windings++; // (The 'work' our pretend app does)
     lastAppAnimationTime = now;
 
     // Display the updated data
@@ -299,16 +414,35 @@ void setup() {
     // Must call this (or no LCD output will be generated)
 	Wire.begin(SDA_PIN, SCL_PIN);
 
-    // NOTE: The menu system uses custom characters 1,2 & 3
-
-    // THESE are used as part of the Action animation
-    // (note who I do not overrwite 1, 2,3)
-    lcd.createChar(5, custChar1);
-    lcd.createChar(6, custChar2);
-    lcd.createChar(7, custChar3);
-
-	// Currently, the menu system only supports 1602 displays! (but you still need to specify the size!)
-	MenuSystem::begin(16, 2, &lcd, &aEncoder, &bEncoder);
+	// Menus scroll to fit the display - taller displays show more items at once
+#if USE_MENU_PCF8574_TRANSPORT
+	lcd.init(); // (MenuSystem::begin() does this for us, when it's given lcd)
+	lcd.backlight();
+	MenuSystem::begin(LCD_COLUMNS, LCD_ROWS, &menuDisplay, &aEncoder, &bEncoder);
+#else
+	MenuSystem::begin(LCD_COLUMNS, LCD_ROWS, &lcd, &aEncoder, &bEncoder);
+#endif
+
+    // Let the speed setting accelerate when either encoder is spun quickly
+    mmSpeed.setAcceleration();
+    mmSpeed.onCommit(stepperSettingsChanged);
+    mmWidth.onCommit(stepperSettingsChanged);
+    cfgWireGauge.onCommit(wireGaugeChosen);
+    // Restore the settings saved last time - each needs a key of its own, which mustn't change
+    mmDirection.persist(1);
+    mmSpeed.persist(2);
+    mmWidth.persist(3);
+    mmOperationMode.persist(4);
+    mmColour.persist(5);
+    cfgVolume.persist(6);
+    cfgBrightness.persist(7);
+    cfgWireDiameter.persist(8);
+    cfgWireGauge.persist(9);
+#if defined(ESP32)
+    if (!MenuSystem::beginSettings(&settingsStorage))
+        Serial.println("No \"menu\" partition - settings won't be saved");
+#endif
+    cfgWireDiameter.publishTo(&wireMicrons);
 
     // Start the main menu
 	mainMenu.takeFocus();
@@ -318,6 +452,9 @@ void loop() {
     // It's good practice to implement your "Actions" in a non-blocking way,
     // so this loop() fun can continue to be called at regular intervals
 
+    // Handle any encoder input which has arrived since we last looked (and update the LCD)
+    MenuSystem::poll();
+
     // appAnimate() will do a small amount of work on behalf of the Action
     // (invokded from MenuAction) before returning control
     appAnimate();
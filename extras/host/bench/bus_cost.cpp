@@ -0,0 +1,323 @@
+// Drives the BasicUsage example's menu tree through a scripted session and reports the
+// PCF8574 (I2C) traffic each encoder event generates, grouped by the class of menu item
+// which was handling it.  Built with USE_MENU_PCF8574_TRANSPORT=1, the menus use the batched
+// MenuPCF8574Transport, and the speed-up over LiquidCrystal_I2C is reported as well.
+// Finally, a fast spin is repeated with and without MenuSystem::setRenderLimits().
+
+#include <Arduino.h>
+
+// The Arduino IDE generates prototypes for sketch functions - we have to do it ourselves
+void appDrawData();
+void appReDraw();
+
+#include "../../../examples/BasicUsage/BasicUsage.ino"
+
+#define I2C_CLOCK_HZ 100000
+
+struct ClassCost
+{
+    const char *name;
+    unsigned long events;
+    LcdBusStats bus;
+};
+
+static ClassCost costs[] = {
+    {"Menu", 0, {}},
+    {"MenuBoolValue", 0, {}},
+    {"MenuLongValue", 0, {}},
+    {"MenuFloatValue", 0, {}},
+    {"MenuDropDownListValue", 0, {}},
+    {"MenuRotaryListValue", 0, {}},
+    {"MenuAction", 0, {}},
+    {"MenuFixedValue", 0, {}},
+    {"MenuLongValue (16 detent spin)", 0, {}},
+    {"MenuDashboard", 0, {}},
+    {"MenuWatchValue (live update)", 0, {}},
+    {"MenuDropDownListValue (provider)", 0, {}},
+    {"MenuDynamic", 0, {}},
+};
+
+enum COST_CLASS
+{
+    C_MENU,
+    C_BOOL,
+    C_LONG,
+    C_FLOAT,
+    C_DROP_DOWN,
+    C_ROTARY,
+    C_ACTION,
+    C_FIXED,
+    C_SPIN,
+    C_DASHBOARD,
+    C_WATCH,
+    C_LIST_PROVIDER,
+    C_DYNAMIC
+};
+
+static bool verbose = false;
+
+// What LiquidCrystal_I2C would have put on the bus for the same HD44780 instructions & characters
+// (every one is 6 single-byte expander writes)
+static LcdBusStats asLiquidCrystal(const LcdBusStats &bus)
+{
+    LcdBusStats lc = bus;
+    lc.transactions = (bus.commands + bus.characters) * 6;
+    lc.bytes = lc.transactions * 2;
+    return lc;
+}
+
+static double eventMicros(const LcdBusStats &bus)
+{
+    return bus.busMicros(I2C_CLOCK_HZ) + bus.blockedMicros;
+}
+
+static void showFrame(const char *label);
+
+static void accumulate(COST_CLASS cls)
+{
+    ClassCost &c = costs[cls];
+    c.events++;
+    c.bus.transactions += lcd.stats.transactions;
+    c.bus.bytes += lcd.stats.bytes;
+    c.bus.commands += lcd.stats.commands;
+    c.bus.characters += lcd.stats.characters;
+    c.bus.clears += lcd.stats.clears;
+    c.bus.blockedMicros += lcd.stats.blockedMicros;
+    lcd.resetStats();
+    if (verbose)
+        showFrame(c.name);
+}
+
+// One encoder event, followed by one pass of the sketch's loop() (which calls MenuSystem::poll())
+static void turn(RotaryEncoder &encoder, int detents, COST_CLASS cls)
+{
+    for (int i = 0; i < abs(detents); i++)
+    {
+        encoder.turn(detents > 0);
+        loop();
+        accumulate(cls);
+    }
+}
+
+static void press(RotaryEncoder &encoder, COST_CLASS cls)
+{
+    encoder.press();
+    loop();
+    accumulate(cls);
+}
+
+static void printCost(const ClassCost &c)
+{
+    if (!c.events)
+        return;
+    printf("%-32s %7lu %10.1f %10.1f %10.1f %12.0f %12.0f %7.1fx\n", c.name, c.events,
+           (double)c.bus.transactions / c.events,
+           (double)c.bus.bytes / c.events,
+           (double)c.bus.characters / c.events,
+           eventMicros(c.bus) / c.events,
+           eventMicros(asLiquidCrystal(c.bus)) / c.events,
+           eventMicros(asLiquidCrystal(c.bus)) / eventMicros(c.bus));
+}
+
+static void showFrame(const char *label)
+{
+    char row[MENU_SYSTEM_MAX_COLS + 1];
+
+    printf("%s\n", label);
+    for (int r = 0; r < lcd.height(); r++)
+    {
+        lcd.frameRow(r, row);
+        for (char *p = row; *p; p++)
+            if ((unsigned char)*p < ' ')
+                *p = '0' + *p; // Show custom characters as their slot number
+        printf("  |%s|\n", row);
+    }
+}
+
+// Turn the fine encoder 'detents' times, 1ms apart, calling loop() in between (as a sketch would), then
+// keep looping until the display has caught up.  Reports what that cost, and checks the LCD ended up
+// showing the whole frame.
+static void spin(int detents, unsigned int maxFramesPerSecond, unsigned int frameByteBudget)
+{
+    char before[MENU_SYSTEM_MAX_ROWS][MENU_SYSTEM_MAX_COLS + 1];
+    char after[MENU_SYSTEM_MAX_COLS + 1];
+    bool complete = true;
+
+    MenuSystem::setRenderLimits(maxFramesPerSecond, frameByteBudget);
+    MenuSystem::resetStats();
+    lcd.resetStats();
+    unsigned long start = millis();
+    for (int i = 0; i < abs(detents); i++)
+    {
+        bEncoder.turn(detents > 0);
+        loop();
+        delay(1);
+    }
+    for (int i = 0; i < 200; i++) // Anything held back goes out within a few frames
+    {
+        loop();
+        delay(1);
+    }
+    unsigned long elapsed = millis() - start;
+    MenuSystemStats stats = MenuSystem::getStats();
+    unsigned long busBytes = lcd.stats.bytes;
+
+    // flush() ignores the limits - if the LCD was up to date, repainting it changes nothing
+    for (int r = 0; r < lcd.height(); r++)
+        lcd.frameRow(r, before[r]);
+    MenuSystem::invalidateDisplay();
+    MenuSystem::flush();
+    for (int r = 0; r < lcd.height(); r++)
+    {
+        lcd.frameRow(r, after);
+        complete = complete && !strcmp(before[r], after);
+    }
+
+    char limits[32];
+    if (maxFramesPerSecond || frameByteBudget)
+        snprintf(limits, sizeof(limits), "%u fps, %u bytes", maxFramesPerSecond, frameByteBudget);
+    else
+        snprintf(limits, sizeof(limits), "unlimited");
+    printf("%-20s %7lu %7lu %10lu %10lu %9lu %10lu %8s\n", limits, stats.flushes, stats.flushesCut, stats.flushBytesMax,
+           (unsigned long)stats.latencyMax / 1000, elapsed, busBytes, complete ? "yes" : "NO");
+    MenuSystem::setRenderLimits(0, 0);
+}
+
+int main(int argc, char **argv)
+{
+    verbose = argc > 1 && !strcmp(argv[1], "-v");
+
+    setup();
+    loop(); // Draws the main menu
+    lcd.resetStats();
+    showFrame("Start:");
+
+    // Scroll the main menu (Run App., Set Rotation, Configuration, Set Speed, Set Width, Select Mode, Colour)
+    turn(aEncoder, 6, C_MENU);
+    turn(aEncoder, -6, C_MENU);
+
+    // Set Rotation
+    turn(aEncoder, 1, C_MENU);
+    press(aEncoder, C_BOOL);
+    turn(aEncoder, 3, C_BOOL);
+    turn(bEncoder, -3, C_BOOL);
+    press(aEncoder, C_BOOL);
+
+    // Set Speed (coarse, then fine), then one fast spin handled by a single poll()
+    turn(aEncoder, 2, C_MENU);
+    press(aEncoder, C_LONG);
+    turn(aEncoder, 5, C_LONG);
+    turn(bEncoder, -5, C_LONG);
+    for (int i = 0; i < MENU_SYSTEM_EVENT_QUEUE_SIZE; i++)
+        bEncoder.turn(true);
+    loop();
+    accumulate(C_SPIN);
+    press(aEncoder, C_LONG);
+
+    // Set Width
+    turn(aEncoder, 1, C_MENU);
+    press(aEncoder, C_FLOAT);
+    turn(aEncoder, 5, C_FLOAT);
+    turn(bEncoder, -5, C_FLOAT);
+    press(bEncoder, C_FLOAT);
+
+    // Select Mode
+    turn(aEncoder, 1, C_MENU);
+    press(aEncoder, C_DROP_DOWN);
+    turn(aEncoder, 3, C_DROP_DOWN);
+    turn(aEncoder, -2, C_DROP_DOWN);
+    press(aEncoder, C_DROP_DOWN);
+
+    // Colour - each press steps through the list, a turn hands back to the menu
+    turn(aEncoder, 1, C_MENU);
+    for (int i = 0; i < 5; i++)
+        press(aEncoder, C_ROTARY);
+    turn(aEncoder, -1, C_ROTARY);
+
+    // Configuration sub-menu, then back out via its return entry
+    turn(aEncoder, -3, C_MENU);
+    press(aEncoder, C_MENU);
+    turn(aEncoder, 3, C_MENU);
+    press(aEncoder, C_FIXED);
+    turn(aEncoder, 3, C_FIXED);
+    turn(bEncoder, -4, C_FIXED);
+    press(aEncoder, C_FIXED);
+    // Wire Gauge - its entries come from a provider, so scrolling back is redrawn from the cache
+    turn(aEncoder, 1, C_MENU);
+    press(aEncoder, C_LIST_PROVIDER);
+    turn(aEncoder, 3, C_LIST_PROVIDER);
+    turn(aEncoder, -3, C_LIST_PROVIDER);
+    turn(bEncoder, 1, C_LIST_PROVIDER);
+    press(aEncoder, C_LIST_PROVIDER);
+    // Recipes - a MenuDynamic: scroll to the bottom, edit the last recipe, then scroll back up & return
+    turn(aEncoder, 1, C_MENU);
+    press(aEncoder, C_DYNAMIC);
+    turn(aEncoder, 12, C_DYNAMIC);
+    press(aEncoder, C_LONG);
+    turn(aEncoder, 2, C_LONG);
+    press(aEncoder, C_LONG);
+    turn(aEncoder, -13, C_DYNAMIC);
+    press(aEncoder, C_DYNAMIC);
+    turn(aEncoder, -6, C_MENU);
+    press(aEncoder, C_MENU);
+
+    // Status - the live values change (as if the stepper were running), and are redrawn as poll() samples them
+    turn(aEncoder, 6, C_MENU);
+    press(aEncoder, C_DASHBOARD);
+    for (int i = 0; i < 5; i++)
+    {
+        windings += 37;
+        speed -= 10;
+        delay(210); // Longer than their sample interval
+        loop();
+        accumulate(C_WATCH);
+    }
+    turn(aEncoder, 1, C_DASHBOARD);
+    press(aEncoder, C_DASHBOARD);
+    turn(aEncoder, -6, C_MENU);
+
+    // Run App. - the action draws for itself, then we exit via its options menu
+    turn(aEncoder, -2, C_MENU);
+    press(aEncoder, C_ACTION);
+    press(aEncoder, C_DROP_DOWN);
+    turn(aEncoder, 2, C_DROP_DOWN);
+    press(aEncoder, C_ACTION);
+    showFrame("End:");
+
+    printf("\nPCF8574 traffic per encoder event (%d x %d display, %s, bus time at %d kHz)\n", LCD_COLUMNS, LCD_ROWS,
+           USE_MENU_PCF8574_TRANSPORT ? "MenuPCF8574Transport" : "LiquidCrystal_I2C", I2C_CLOCK_HZ / 1000);
+    printf("%-32s %7s %10s %10s %10s %12s %12s %8s\n", "Class", "events", "trans/evt", "bytes/evt", "chars/evt", "bus us/evt",
+           "LCD_I2C us", "speed-up");
+    ClassCost total = {"Total", 0, {}};
+    for (unsigned int i = 0; i < sizeof(costs) / sizeof(costs[0]); i++)
+    {
+        printCost(costs[i]);
+        total.events += costs[i].events;
+        total.bus.transactions += costs[i].bus.transactions;
+        total.bus.bytes += costs[i].bus.bytes;
+        total.bus.commands += costs[i].bus.commands;
+        total.bus.characters += costs[i].bus.characters;
+        total.bus.blockedMicros += costs[i].bus.blockedMicros;
+    }
+    printCost(total);
+
+    printf("\nMenuSystem::printStats() for the whole session:\n");
+    MenuSystem::printStats();
+
+    // Set Speed, spun down & back up with the fine encoder (without acceleration, so every detent changes the display)
+    mmSpeed.setAcceleration(nullptr);
+    turn(aEncoder, 3, C_MENU);
+    press(aEncoder, C_LONG);
+    showFrame("\nSet Speed:");
+    printf("\nFast spin (100 detents down, then up, 1ms apart) with MenuSystem::setRenderLimits()\n");
+    printf("%-20s %7s %7s %10s %10s %9s %10s %8s\n", "Limits", "frames", "cut", "max bytes", "max lat ms", "time ms",
+           "bus bytes", "complete");
+    for (int i = 0; i < 3; i++)
+    {
+        static const unsigned int limits[][2] = {{0, 0}, {30, 0}, {30, 48}};
+        spin(-100, limits[i][0], limits[i][1]);
+        spin(100, limits[i][0], limits[i][1]);
+    }
+    press(aEncoder, C_LONG);
+    return 0;
+}
@@ -0,0 +1,326 @@
+// Times the menu engine itself, on the host, for tracking regressions between releases:
+//  - render/    each item class's render path into the frame (no bus traffic)
+//  - dispatch/  an encoder event from the static encoder callbacks through poll() to inputHandler()
+//               (including drawing the result & flushing it to the LCD)
+//  - scenario/  a 1000 item menu (static & MenuDynamic) scrolled end to end, 500 detent spins of a
+//               value editor, and menus nested as deep as the focus stack, down & back up again
+// Each is run REPEATS times and the fastest kept.  The results are written as CSV (benchmark,
+// iterations, ns per operation, I2C bus bytes per operation), or with --json as a JSON array - run it
+// with `make engine` (which also writes build/engine.csv).  The library is built with MENU_SYSTEM_STATS=1,
+// as for the other host tools, so the timings include the statistics' own (small) cost.
+
+#include <Arduino.h>
+#include <Wire.h>
+#include <DualEncoderMenuSystem.h>
+#include <chrono>
+#include <string.h>
+
+#define REPEATS 5
+#define RENDER_ITERATIONS 20000
+#define DISPATCH_ITERATIONS 5000
+#define BIG_MENU_ITEMS 1000
+#define SPIN_DETENTS 500
+#define SPIN_BURST 10 // Detents which arrive between polls in a fast spin (less than MENU_SYSTEM_EVENT_QUEUE_SIZE)
+#define NEST_DEPTH (MENU_SYSTEM_FOCUS_DEPTH - 1) // Below the root menu
+
+LiquidCrystal_I2C lcd(0x27, 20, 4);
+RotaryEncoder aEncoder(21, 22, 23);
+RotaryEncoder bEncoder(32, 33, 34);
+
+// Something of each class, in a menu of its own
+bool enabled = false;
+long speed = 1000;
+float ratio = 1.5;
+long diameter = 355;
+int mode = 0;
+int colour = 0;
+int gauge = 0;
+
+MenuBoolValue mmEnabled(MenuLabel("Enabled"), MenuOption("Yes"), MenuOption("No"), &enabled);
+MenuLongValue mmSpeed(MenuLabel("Speed"), MenuLabel("rpm"), 0, 2000, 100, 10, &speed);
+MenuFloatValue mmRatio(MenuLabel("Ratio"), MenuLabel(""), 0.5, 4.0, 0.1, 0.01, &ratio);
+MenuFixedValue mmDiameter(MenuLabel("Diameter"), MenuLabel("mm"), 3, 50, 2000, 50, 1, &diameter);
+MENU_LIST(modes, "Automatic", "Manual", "Test", "Calibrate");
+MenuDropDownListValue mmMode(MenuLabel("Mode"), modes, &mode);
+MENU_LIST(colours, "Red", "Green", "Blue");
+MenuRotaryListValue mmColour(MenuLabel("Colour"), colours, &colour);
+static int gaugeCount() { return 40; }
+static void gaugeText(int index, char *text, size_t size) { snprintf(text, size, "%d AWG", index); }
+MenuDropDownListValue mmGauge(MenuLabel("Gauge"), gaugeCount, gaugeText, &gauge);
+
+// The 1000 item menus: one of real items, and a MenuDynamic building them as they're needed
+static long bigValues[BIG_MENU_ITEMS];
+static char bigLabels[BIG_MENU_ITEMS][12];
+static MenuSystem *bigItems[BIG_MENU_ITEMS + 1];
+Menu *bigMenu;
+
+class BigGenerator : public MenuItemGenerator
+{
+public:
+    int count() override { return BIG_MENU_ITEMS; }
+    MenuSystem *build(int index, MenuItemSlot &slot) override
+    {
+        snprintf(slot.label, sizeof(slot.label), "Item %d", index + 1);
+        return slot.make<MenuLongValue>(slot.label, "", 0L, 100L, 10L, 1L, &bigValues[index]);
+    }
+};
+BigGenerator bigGenerator;
+MenuDynamic dynamicMenu(MenuLabel("Generated"), &bigGenerator);
+
+// Menus nested below the root menu, filling the focus stack
+static char nestLabels[NEST_DEPTH][12];
+static MenuSystem *nestItems[NEST_DEPTH][2];
+Menu *nest[NEST_DEPTH];
+
+// (Finished by main(), once the 1000 item & nested menus have been built)
+enum ROOT_ENTRY
+{
+    R_BOOL,
+    R_LONG,
+    R_FLOAT,
+    R_FIXED,
+    R_DROP_DOWN,
+    R_ROTARY,
+    R_PROVIDER,
+    R_BIG,
+    R_DYNAMIC,
+    R_NEST,
+    R_COUNT
+};
+static MenuSystem *rootItems[R_COUNT + 1] = {&mmEnabled, &mmSpeed, &mmRatio, &mmDiameter, &mmMode, &mmColour, &mmGauge};
+Menu *rootMenu;
+
+struct Result
+{
+    const char *name;
+    unsigned long iterations;
+    double nsPerOp;
+    double busBytesPerOp;
+};
+
+static Result results[40];
+static int resultCount = 0;
+
+// Run body(i) for i = 0 .. iterations - 1, REPEATS times, keeping the fastest.  reset() (if any) is
+// called, untimed, before each run, to put the menus back where the run expects them.
+template <class Body, class Reset>
+static void measure(const char *name, unsigned long iterations, Body body, Reset reset)
+{
+    Result &result = results[resultCount++];
+
+    result.name = name;
+    result.iterations = iterations;
+    result.nsPerOp = -1;
+    for (int repeat = 0; repeat < REPEATS; repeat++)
+    {
+        reset();
+        lcd.resetStats();
+        auto start = std::chrono::steady_clock::now();
+        for (unsigned long i = 0; i < iterations; i++)
+            body(i);
+        double elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+        if (result.nsPerOp < 0 || elapsed / iterations < result.nsPerOp)
+        {
+            result.nsPerOp = elapsed / iterations;
+            result.busBytesPerOp = (double)lcd.stats.bytes / iterations;
+        }
+    }
+}
+
+template <class Body>
+static void measure(const char *name, unsigned long iterations, Body body)
+{
+    measure(name, iterations, body, [] {});
+}
+
+// Back to the root menu, on its first entry
+static void home()
+{
+    MenuContext::primary.start(rootMenu);
+    for (int i = 0; i < R_COUNT; i++)
+        MenuSystem::encoderAturned(0);
+    MenuSystem::poll();
+}
+
+// Open entry index of the root menu
+static void open(ROOT_ENTRY index)
+{
+    home();
+    for (int i = 0; i < index; i++)
+        MenuSystem::encoderAturned(1);
+    MenuSystem::encoderApressed(1);
+    MenuSystem::poll();
+}
+
+static void renderBenchmarks()
+{
+    home();
+    measure("render/Menu::displayValue", RENDER_ITERATIONS, [](unsigned long i) { rootMenu->displayValue(); });
+    measure("render/Menu::display (entry row)", RENDER_ITERATIONS, [](unsigned long i) { mmSpeed.display(i & 3, i & 1); });
+
+    open(R_BOOL);
+    measure("render/MenuBoolValue::displayValue", RENDER_ITERATIONS, [](unsigned long i) {
+        enabled = i & 1;
+        mmEnabled.displayValue();
+    });
+    open(R_LONG);
+    measure("render/MenuLongValue::displayValue", RENDER_ITERATIONS, [](unsigned long i) {
+        speed = i % 2001;
+        mmSpeed.displayValue();
+    });
+    open(R_FLOAT);
+    measure("render/MenuFloatValue::displayValue", RENDER_ITERATIONS, [](unsigned long i) {
+        ratio = 0.5 + (i % 351) * 0.01;
+        mmRatio.displayValue();
+    });
+    open(R_FIXED);
+    measure("render/MenuFixedValue::displayValue", RENDER_ITERATIONS, [](unsigned long i) {
+        diameter = 50 + i % 1951;
+        mmDiameter.displayValue();
+    });
+    open(R_DROP_DOWN);
+    measure("render/MenuDropDownListValue::displayValue", RENDER_ITERATIONS, [](unsigned long i) {
+        mode = i % 4;
+        mmMode.displayValue();
+    });
+    home();
+    measure("render/MenuRotaryListValue::display", RENDER_ITERATIONS, [](unsigned long i) {
+        colour = i % 3;
+        mmColour.display(1, true);
+    });
+    open(R_PROVIDER);
+    measure("render/MenuDropDownListValue::displayValue (provider)", RENDER_ITERATIONS, [](unsigned long i) {
+        gauge = i % 40; // (More entries than the list cache holds, so most are fetched)
+        mmGauge.displayValue();
+    });
+}
+
+static void dispatchBenchmarks()
+{
+    // Up & down between two entries - the Menu redraws only the rows losing & gaining the marker
+    measure("dispatch/Menu turn", DISPATCH_ITERATIONS, [](unsigned long i) {
+        MenuSystem::encoderAturned(~i & 1);
+        MenuSystem::poll();
+    }, [] { home(); });
+    measure("dispatch/MenuLongValue turn", DISPATCH_ITERATIONS, [](unsigned long i) {
+        MenuSystem::encoderBturned(i & 1);
+        MenuSystem::poll();
+    }, [] { open(R_LONG); });
+    measure("dispatch/MenuBoolValue turn", DISPATCH_ITERATIONS, [](unsigned long i) {
+        MenuSystem::encoderAturned(i & 1);
+        MenuSystem::poll();
+    }, [] { open(R_BOOL); });
+    // Into the Speed editor & straight back out (returning to a kept screen)
+    measure("dispatch/press (open & return)", DISPATCH_ITERATIONS, [](unsigned long i) {
+        MenuSystem::encoderApressed(1);
+        MenuSystem::poll();
+    }, [] {
+        home();
+        MenuSystem::encoderAturned(1);
+        MenuSystem::poll();
+    });
+    home();
+}
+
+static void scenarioBenchmarks()
+{
+    // Scrolled from the first entry to the last & back, a poll per detent
+    measure("scenario/Menu 1000 items scroll", 2 * (BIG_MENU_ITEMS - 1), [](unsigned long i) {
+        MenuSystem::encoderAturned(i < BIG_MENU_ITEMS - 1);
+        MenuSystem::poll();
+    }, [] { open(R_BIG); });
+    measure("scenario/MenuDynamic 1000 items scroll", 2 * (BIG_MENU_ITEMS - 1), [](unsigned long i) {
+        MenuSystem::encoderAturned(i < BIG_MENU_ITEMS - 1);
+        MenuSystem::poll();
+    }, [] { open(R_DYNAMIC); });
+    // Opened from the root menu, then back to it by the return entry (3 events)
+    measure("scenario/Menu 1000 items open & return", 300, [](unsigned long i) {
+        if (i % 3 == 1)
+            MenuSystem::encoderAturned(0);
+        else
+            MenuSystem::encoderApressed(1);
+        MenuSystem::poll();
+    }, [] {
+        home();
+        for (int i = 0; i < R_BIG; i++)
+            MenuSystem::encoderAturned(1);
+        MenuSystem::poll();
+    });
+
+    // A 500 detent spin of the Speed editor's fine encoder (the value bounces off its limits), polled after
+    // every detent, and in bursts as a fast spin arrives - with and without acceleration
+    measure("scenario/spin 500 detents, poll per detent", SPIN_DETENTS, [](unsigned long i) {
+        MenuSystem::encoderBturned(i < SPIN_DETENTS / 2);
+        MenuSystem::poll();
+    }, [] { open(R_LONG); });
+    measure("scenario/spin 500 detents, bursts of 10", SPIN_DETENTS / SPIN_BURST, [](unsigned long i) {
+        for (int detent = 0; detent < SPIN_BURST; detent++)
+            MenuSystem::encoderBturned(i < SPIN_DETENTS / SPIN_BURST / 2);
+        MenuSystem::poll();
+    }, [] { open(R_LONG); });
+    mmSpeed.setAcceleration();
+    measure("scenario/spin 500 detents, bursts of 10, accelerated", SPIN_DETENTS / SPIN_BURST, [](unsigned long i) {
+        for (int detent = 0; detent < SPIN_BURST; detent++)
+            MenuSystem::encoderBturned(i < SPIN_DETENTS / SPIN_BURST / 2);
+        MenuSystem::poll();
+    }, [] { open(R_LONG); });
+    mmSpeed.setAcceleration(nullptr);
+
+    // Down through every level (a press each), then back up (to the return entry & press)
+    measure("scenario/nested menus down & up", 3 * (NEST_DEPTH - 1), [](unsigned long i) {
+        if (i < NEST_DEPTH - 1 || (i - (NEST_DEPTH - 1)) % 2)
+            MenuSystem::encoderApressed(1);
+        else
+            MenuSystem::encoderAturned(0);
+        MenuSystem::poll();
+    }, [] { open(R_NEST); });
+    home();
+}
+
+int main(int argc, char **argv)
+{
+    bool json = argc > 1 && !strcmp(argv[1], "--json");
+
+    for (int i = 0; i < BIG_MENU_ITEMS; i++)
+    {
+        snprintf(bigLabels[i], sizeof(bigLabels[i]), "Item %d", i + 1);
+        bigItems[i] = new MenuLongValue(bigLabels[i], "", 0, 100, 10, 1, &bigValues[i]);
+    }
+    bigItems[BIG_MENU_ITEMS] = nullptr;
+    bigMenu = new Menu("Big Menu", bigItems);
+    for (int level = NEST_DEPTH - 1; level >= 0; level--)
+    {
+        snprintf(nestLabels[level], sizeof(nestLabels[level]), "Level %d", level + 1);
+        nestItems[level][0] = level < NEST_DEPTH - 1 ? (MenuSystem *)nest[level + 1] : &mmSpeed;
+        nestItems[level][1] = nullptr;
+        nest[level] = new Menu(nestLabels[level], nestItems[level]);
+    }
+    rootItems[R_BIG] = bigMenu;
+    rootItems[R_DYNAMIC] = &dynamicMenu;
+    rootItems[R_NEST] = nest[0];
+    rootMenu = new Menu("Main Menu", rootItems);
+
+    Wire.begin();
+    MenuSystem::begin(20, 4, &lcd, &aEncoder, &bEncoder);
+    rootMenu->takeFocus();
+    renderBenchmarks();
+    dispatchBenchmarks();
+    scenarioBenchmarks();
+
+    if (json)
+    {
+        printf("[\n");
+        for (int i = 0; i < resultCount; i++)
+            printf("  {\"benchmark\": \"%s\", \"iterations\": %lu, \"ns_per_op\": %.1f, \"bus_bytes_per_op\": %.1f}%s\n",
+                   results[i].name, results[i].iterations, results[i].nsPerOp, results[i].busBytesPerOp, i < resultCount - 1 ? "," : "");
+        printf("]\n");
+    }
+    else
+    {
+        printf("benchmark,iterations,ns_per_op,bus_bytes_per_op\n");
+        for (int i = 0; i < resultCount; i++)
+            printf("\"%s\",%lu,%.1f,%.1f\n", results[i].name, results[i].iterations, results[i].nsPerOp, results[i].busBytesPerOp);
+    }
+    return 0;
+}
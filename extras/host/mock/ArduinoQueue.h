@@ -0,0 +1,4 @@
+// Host stand-in - BasicUsage.ino includes this but the menu system doesn't use it
+#ifndef HOST_ARDUINO_QUEUE_H
+#define HOST_ARDUINO_QUEUE_H
+#endif
@@ -0,0 +1,43 @@
+// Host stand-in for ESP32RotaryEncoder - turn()/press() replay input through the registered callbacks
+#ifndef HOST_ESP32_ROTARY_ENCODER_H
+#define HOST_ESP32_ROTARY_ENCODER_H
+
+#include <Arduino.h>
+
+enum class EncoderType
+{
+    HAS_PULLUP,
+    FLOATING
+};
+
+typedef void (*EncoderCallback)(long value);
+typedef void (*ButtonCallback)(unsigned long duration);
+
+class RotaryEncoder
+{
+protected:
+    EncoderCallback turnedCallback = nullptr;
+    ButtonCallback pressedCallback = nullptr;
+
+public:
+    RotaryEncoder(uint8_t encoderPinA, uint8_t encoderPinB, int8_t buttonPin = -1) {}
+    void setEncoderType(EncoderType type) {}
+    void setBoundaries(long minValue = -1, long maxValue = 1, bool circleValues = false) {}
+    void begin() {}
+    void onTurned(EncoderCallback f) { turnedCallback = f; }
+    void onPressed(ButtonCallback f) { pressedCallback = f; }
+
+    // Simulation: one detent clockwise (true) or anticlockwise (false)
+    void turn(bool clockwise)
+    {
+        if (turnedCallback)
+            turnedCallback(clockwise ? 1 : 0);
+    }
+    void press(unsigned long duration = 50)
+    {
+        if (pressedCallback)
+            pressedCallback(duration);
+    }
+};
+
+#endif // HOST_ESP32_ROTARY_ENCODER_H
@@ -0,0 +1,100 @@
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/semphr.h>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+struct HostTask
+{
+    TaskFunction_t function;
+    void *parameters;
+    std::mutex mutex;
+    std::condition_variable notified;
+    uint32_t notifications = 0;
+};
+
+struct HostSemaphore
+{
+    std::recursive_timed_mutex mutex;
+};
+
+// The task each thread is running (nullptr for the main thread)
+static thread_local HostTask *currentTask = nullptr;
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t function, const char *name, uint32_t stackDepth, void *parameters,
+                                   UBaseType_t priority, TaskHandle_t *createdTask, BaseType_t coreId)
+{
+    HostTask *task = new HostTask();
+
+    task->function = function;
+    task->parameters = parameters;
+    if (createdTask)
+        *createdTask = task;
+    // Tasks are never joined - like FreeRTOS tasks, they end by deleting themselves.  The HostTask is
+    // leaked, as other tasks may still hold its handle.
+    std::thread([task]() {
+        currentTask = task;
+        task->function(task->parameters);
+    }).detach();
+    return pdPASS;
+}
+
+void vTaskDelete(TaskHandle_t task)
+{
+}
+
+void vTaskDelay(TickType_t ticks)
+{
+    std::this_thread::sleep_for(std::chrono::milliseconds(ticks));
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clearCountOnExit, TickType_t ticksToWait)
+{
+    HostTask *task = currentTask;
+    uint32_t count;
+
+    if (!task)
+        return 0;
+    std::unique_lock<std::mutex> lock(task->mutex);
+    if (ticksToWait == portMAX_DELAY)
+        task->notified.wait(lock, [task]() { return task->notifications > 0; });
+    else
+        task->notified.wait_for(lock, std::chrono::milliseconds(ticksToWait), [task]() { return task->notifications > 0; });
+    count = task->notifications;
+    if (count)
+        task->notifications = clearCountOnExit ? 0 : count - 1;
+    return count;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task)
+{
+    {
+        std::lock_guard<std::mutex> lock(task->mutex);
+        task->notifications++;
+    }
+    task->notified.notify_one();
+    return pdPASS;
+}
+
+SemaphoreHandle_t xSemaphoreCreateRecursiveMutex()
+{
+    return new HostSemaphore();
+}
+
+BaseType_t xSemaphoreTakeRecursive(SemaphoreHandle_t mutex, TickType_t ticksToWait)
+{
+    if (ticksToWait == portMAX_DELAY)
+    {
+        mutex->mutex.lock();
+        return pdTRUE;
+    }
+    return mutex->mutex.try_lock_for(std::chrono::milliseconds(ticksToWait)) ? pdTRUE : pdFALSE;
+}
+
+BaseType_t xSemaphoreGiveRecursive(SemaphoreHandle_t mutex)
+{
+    mutex->mutex.unlock();
+    return pdTRUE;
+}
@@ -0,0 +1,113 @@
+#include "HD44780.h"
+
+#define PIN_RS 0x01
+#define PIN_E 0x04
+
+HostHD44780::HostHD44780()
+{
+    memset(ddram, ' ', sizeof(ddram));
+    memset(cgram, 0, sizeof(cgram));
+}
+
+HostHD44780 *HostHD44780::at(uint8_t address)
+{
+    static HostHD44780 *displays[128];
+
+    address &= 0x7F;
+    if (!displays[address])
+    {
+        displays[address] = new HostHD44780();
+        TwoWire::attach(address, displays[address]);
+    }
+    return displays[address];
+}
+
+void HostHD44780::receive(const uint8_t *data, int length)
+{
+    stats.transactions++;
+    stats.bytes += length + 1;
+    for (int i = 0; i < length; i++)
+    {
+        // The HD44780 latches D4-D7 (and RS) as E falls
+        if ((pins & PIN_E) && !(data[i] & PIN_E))
+            strobe(pins);
+        pins = data[i];
+    }
+}
+
+void HostHD44780::strobe(uint8_t pins)
+{
+    uint8_t nibble = pins >> 4;
+
+    if (eightBit)
+        execute(pins & PIN_RS, nibble << 4); // Only D4-D7 are wired, D0-D3 read as 0
+    else if (!lowNibbleNext)
+    {
+        highNibble = nibble << 4;
+        lowNibbleNext = true;
+    }
+    else
+    {
+        lowNibbleNext = false;
+        execute(pins & PIN_RS, highNibble | nibble);
+    }
+}
+
+void HostHD44780::execute(bool rs, uint8_t value)
+{
+    if (rs)
+    {
+        stats.characters++;
+        if (cgMode)
+        {
+            cgram[address & 0x3F] = value;
+            address = (address + 1) & 0x3F;
+        }
+        else
+        {
+            ddram[address & 0x7F] = value;
+            address = (address + 1) & 0x7F;
+        }
+        return;
+    }
+
+    stats.commands++;
+    if (value & 0x80)
+    {
+        address = value & 0x7F;
+        cgMode = false;
+    }
+    else if (value & 0x40)
+    {
+        address = value & 0x3F;
+        cgMode = true;
+    }
+    else if (value & 0x20)
+    {
+        eightBit = value & 0x10;
+        lowNibbleNext = false;
+    }
+    else if (value == 0x01 || (value & 0xFE) == 0x02)
+    {
+        // Clear (or return home) - the driver has to wait ~1.5ms before the next instruction
+        if (value == 0x01)
+            memset(ddram, ' ', sizeof(ddram));
+        address = 0;
+        cgMode = false;
+        stats.clears++;
+        stats.blockedMicros += 2000;
+    }
+}
+
+// Rows 2 & 3 of a 4 line display follow on from rows 0 & 1 in DDRAM
+uint8_t HostHD44780::charAt(int col, int row, int cols) const
+{
+    return ddram[((row & 1 ? 0x40 : 0x00) + (row & 2 ? cols : 0) + col) & 0x7F];
+}
+
+void HostHD44780::frameRow(int row, int cols, char *out) const
+{
+    for (int col = 0; col < cols; col++)
+        out[col] = (char)charAt(col, row, cols);
+    out[cols] = 0;
+}
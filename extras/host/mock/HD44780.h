@@ -0,0 +1,54 @@
+// Host model of an HD44780 LCD controller behind a PCF8574 I2C backpack (P0 = RS, P2 = E,
+// P4-P7 = D4-D7).  Decodes the pin changes of every transaction it receives - whichever
+// driver produced them - into DDRAM/CGRAM contents, and counts the bus traffic.
+#ifndef HOST_HD44780_H
+#define HOST_HD44780_H
+
+#include <Wire.h>
+
+struct LcdBusStats
+{
+    unsigned long transactions = 0; // Wire.beginTransmission()/endTransmission() pairs
+    unsigned long bytes = 0;        // Bytes on the wire, including the address byte of each transaction
+    unsigned long commands = 0;     // HD44780 instructions (setCursor, clear, ...)
+    unsigned long characters = 0;   // HD44780 data writes (DDRAM or CGRAM)
+    unsigned long clears = 0;       // clear()/home() - these also block for ~2ms each
+    unsigned long blockedMicros = 0;
+
+    // Estimated time on the bus: 9 bits per byte, plus start & stop per transaction
+    double busMicros(unsigned long clockHz = 100000) const
+    {
+        return ((double)bytes * 9 + (double)transactions * 2) * 1e6 / clockHz;
+    }
+};
+
+class HostHD44780 : public HostI2CDevice
+{
+protected:
+    uint8_t ddram[128];
+    uint8_t cgram[64];
+    uint8_t address = 0;
+    bool cgMode = false;
+    bool eightBit = true; // Power-on state - the driver's init sequence switches to 4-bit
+    bool lowNibbleNext = false;
+    uint8_t highNibble = 0;
+    uint8_t pins = 0; // Last value written to the PCF8574
+
+    HostHD44780();
+    void strobe(uint8_t pins);
+    void execute(bool rs, uint8_t value);
+
+public:
+    LcdBusStats stats;
+
+    // The display at an I2C address (created, and attached to Wire, the first time it's asked for)
+    static HostHD44780 *at(uint8_t address);
+
+    void receive(const uint8_t *data, int length) override;
+    void resetStats() { stats = LcdBusStats(); }
+    uint8_t charAt(int col, int row, int cols) const;
+    void frameRow(int row, int cols, char *out) const; // out must hold cols + 1
+    const uint8_t *glyph(int slot) const { return &cgram[(slot & 7) * 8]; }
+};
+
+#endif // HOST_HD44780_H
@@ -0,0 +1,83 @@
+#include "HostFileStorage.h"
+#include <fcntl.h>
+#include <unistd.h>
+
+HostFileStorage::HostFileStorage(const char *path, size_t sectorSize, int sectorCount)
+    : path(path), bytesPerSector(sectorSize), sectors(sectorCount), erases(sectorCount, 0) {}
+
+HostFileStorage::~HostFileStorage()
+{
+    if (fd >= 0)
+        close(fd);
+}
+
+// Opens the file - a new one (or one which is too short) is filled out as erased flash
+bool HostFileStorage::begin()
+{
+    if (fd < 0)
+        fd = open(path, O_RDWR | O_CREAT, 0644);
+    if (fd < 0)
+        return false;
+
+    off_t size = lseek(fd, 0, SEEK_END);
+    std::vector<uint8_t> blank(bytesPerSector, 0xFF);
+    for (int i = size / bytesPerSector; i < sectors; i++)
+        if (pwrite(fd, blank.data(), bytesPerSector, i * bytesPerSector) != (ssize_t)bytesPerSector)
+            return false;
+    return true;
+}
+
+// Erase everything
+void HostFileStorage::format()
+{
+    if (begin())
+        for (int i = 0; i < sectors; i++)
+            erase(i);
+}
+
+// Take length bytes from the write budget - cutting length short if the power goes first
+bool HostFileStorage::spend(size_t &length)
+{
+    if (writeBudget < 0)
+        return true;
+    if ((long)length <= writeBudget)
+    {
+        writeBudget -= length;
+        return true;
+    }
+    length = writeBudget;
+    writeBudget = 0;
+    return false;
+}
+
+bool HostFileStorage::read(size_t offset, void *data, size_t length)
+{
+    return fd >= 0 && offset + length <= bytesPerSector * sectors && pread(fd, data, length, offset) == (ssize_t)length;
+}
+
+bool HostFileStorage::write(size_t offset, const void *data, size_t length)
+{
+    uint8_t current[256];
+    const uint8_t *bytes = (const uint8_t *)data;
+    bool powered = spend(length);
+
+    if (fd < 0 || offset + length > bytesPerSector * sectors || length > sizeof(current) || !read(offset, current, length))
+        return false;
+    for (size_t i = 0; i < length; i++)
+        current[i] &= bytes[i]; // Programming only clears bits
+    if (pwrite(fd, current, length, offset) != (ssize_t)length)
+        return false;
+    writes++;
+    bytesWritten += length;
+    return powered;
+}
+
+bool HostFileStorage::erase(int sector)
+{
+    std::vector<uint8_t> blank(bytesPerSector, 0xFF);
+
+    if (fd < 0 || sector < 0 || sector >= sectors || !writeBudget)
+        return false;
+    erases[sector]++;
+    return pwrite(fd, blank.data(), bytesPerSector, sector * bytesPerSector) == (ssize_t)bytesPerSector;
+}
@@ -0,0 +1,41 @@
+// Host stand-in for a flash partition (see MenuStorage), kept in a file so the settings survive
+// from one run to the next.  Behaves like NOR flash: erased bytes read as 0xFF and a write can
+// only clear bits.  Counts the erases of each sector, and can simulate the power going part way
+// through a write (see failAfter()).  Writes are limited to 256 bytes (a record or a sector header
+// at a time is all MenuSettings needs).
+#ifndef HOST_FILE_STORAGE_H
+#define HOST_FILE_STORAGE_H
+
+#include <MenuSettings.h>
+#include <vector>
+
+class HostFileStorage : public MenuStorage
+{
+protected:
+    const char *path;
+    size_t bytesPerSector;
+    int sectors;
+    int fd = -1;
+    long writeBudget = -1; // Bytes which can still be written before the power goes (-1 = no limit)
+
+    bool spend(size_t &length);
+
+public:
+    std::vector<unsigned long> erases; // Per sector
+    unsigned long writes = 0;
+    unsigned long bytesWritten = 0;
+
+    HostFileStorage(const char *path, size_t sectorSize, int sectorCount);
+    ~HostFileStorage();
+    bool begin() override;
+    size_t sectorSize() override { return bytesPerSector; }
+    int sectorCount() override { return sectors; }
+    bool read(size_t offset, void *data, size_t length) override;
+    bool write(size_t offset, const void *data, size_t length) override;
+    bool erase(int sector) override;
+
+    void failAfter(long bytes) { writeBudget = bytes; }
+    void format();
+};
+
+#endif // HOST_FILE_STORAGE_H
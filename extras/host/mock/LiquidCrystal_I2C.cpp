@@ -0,0 +1,94 @@
+#include "LiquidCrystal_I2C.h"
+
+// PCF8574 pins, as the real library
+#define En 0x04
+#define Rs 0x01
+
+LiquidCrystal_I2C::LiquidCrystal_I2C(uint8_t lcd_Addr, uint8_t lcd_cols, uint8_t lcd_rows)
+    : addr(lcd_Addr), cols(lcd_cols), rows(lcd_rows), display(HostHD44780::at(lcd_Addr)), stats(display->stats)
+{
+}
+
+void LiquidCrystal_I2C::expanderWrite(uint8_t data)
+{
+    Wire.beginTransmission(addr);
+    Wire.write(data | backlightVal);
+    Wire.endTransmission();
+}
+
+void LiquidCrystal_I2C::pulseEnable(uint8_t data)
+{
+    expanderWrite(data | En);
+    expanderWrite(data & ~En);
+}
+
+void LiquidCrystal_I2C::write4bits(uint8_t value)
+{
+    expanderWrite(value);
+    pulseEnable(value);
+}
+
+void LiquidCrystal_I2C::send(uint8_t value, uint8_t mode)
+{
+    write4bits((value & 0xF0) | mode);
+    write4bits(((value << 4) & 0xF0) | mode);
+}
+
+// The real library's power-on 4-bit handshake, then function set, display on, clear, entry mode & home
+// (its delays are left out - the display model doesn't need them)
+void LiquidCrystal_I2C::init()
+{
+    expanderWrite(backlightVal);
+    write4bits(0x03 << 4);
+    write4bits(0x03 << 4);
+    write4bits(0x03 << 4);
+    write4bits(0x02 << 4);
+    command(rows > 1 ? 0x28 : 0x20);
+    command(0x0C);
+    clear();
+    command(0x06);
+    home();
+}
+
+void LiquidCrystal_I2C::clear() { command(0x01); }
+void LiquidCrystal_I2C::home() { command(0x02); }
+
+void LiquidCrystal_I2C::setCursor(uint8_t col, uint8_t row)
+{
+    static const uint8_t rowOffsets[] = {0x00, 0x40, 0x14, 0x54};
+
+    if (row >= rows)
+        row = rows - 1;
+    command(0x80 | (col + rowOffsets[row & 3]));
+}
+
+void LiquidCrystal_I2C::backlight()
+{
+    backlightVal = 0x08;
+    expanderWrite(0);
+}
+
+void LiquidCrystal_I2C::noBacklight()
+{
+    backlightVal = 0x00;
+    expanderWrite(0);
+}
+
+void LiquidCrystal_I2C::createChar(uint8_t location, uint8_t charmap[])
+{
+    location &= 0x7;
+    command(0x40 | (location << 3));
+    for (int i = 0; i < 8; i++)
+        write(charmap[i]);
+}
+
+void LiquidCrystal_I2C::command(uint8_t value)
+{
+    send(value, 0);
+}
+
+size_t LiquidCrystal_I2C::write(uint8_t value)
+{
+    send(value, Rs);
+    return 1;
+}
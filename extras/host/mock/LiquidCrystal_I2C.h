@@ -0,0 +1,49 @@
+// Host stand-in for LiquidCrystal_I2C.  Puts exactly the same PCF8574 traffic on the
+// (simulated) I2C bus as the real library, one Wire transaction per expander write,
+// for the HostHD44780 at its address to decode.
+#ifndef HOST_LIQUID_CRYSTAL_I2C_H
+#define HOST_LIQUID_CRYSTAL_I2C_H
+
+#include <Arduino.h>
+#include <Wire.h>
+#include "HD44780.h"
+
+class LiquidCrystal_I2C : public Print
+{
+protected:
+    uint8_t addr;
+    uint8_t cols;
+    uint8_t rows;
+    uint8_t backlightVal = 0x00; // As the real library, the backlight is off until backlight() is called
+    HostHD44780 *display;
+
+    void expanderWrite(uint8_t data);
+    void pulseEnable(uint8_t data);
+    void write4bits(uint8_t value);
+    void send(uint8_t value, uint8_t mode);
+
+public:
+    LcdBusStats &stats; // Everything on the bus to this display (whoever sent it)
+
+    LiquidCrystal_I2C(uint8_t lcd_Addr, uint8_t lcd_cols, uint8_t lcd_rows);
+    void init();
+    void clear();
+    void home();
+    void setCursor(uint8_t col, uint8_t row);
+    void backlight();
+    void noBacklight();
+    void createChar(uint8_t location, uint8_t charmap[]);
+    void command(uint8_t value);
+    size_t write(uint8_t value) override;
+    using Print::write;
+
+    // Simulation helpers
+    void resetStats() { display->resetStats(); }
+    void frameRow(int row, char *out) const { display->frameRow(row, cols, out); } // out must hold cols + 1
+    uint8_t charAt(int col, int row) const { return display->charAt(col, row, cols); }
+    const uint8_t *glyph(int slot) const { return display->glyph(slot); }
+    int width() const { return cols; }
+    int height() const { return rows; }
+};
+
+#endif // HOST_LIQUID_CRYSTAL_I2C_H
@@ -0,0 +1,4 @@
+// Host stand-in - BasicUsage.ino includes this but the menu system doesn't use it
+#ifndef HOST_MULTI_STEPPER_LITE_H
+#define HOST_MULTI_STEPPER_LITE_H
+#endif
@@ -0,0 +1,51 @@
+#include <Wire.h>
+
+TwoWire Wire;
+TwoWire Wire1;
+
+// Function-local, so devices can attach from other static constructors
+static HostI2CDevice **devices()
+{
+    static HostI2CDevice *attached[128];
+    return attached;
+}
+
+void TwoWire::attach(uint8_t address, HostI2CDevice *device)
+{
+    devices()[address & 0x7F] = device;
+}
+
+void TwoWire::beginTransmission(uint8_t address)
+{
+    txAddress = address & 0x7F;
+    txLength = 0;
+}
+
+// Like the real thing, anything beyond the buffer is dropped
+size_t TwoWire::write(uint8_t data)
+{
+    if (txLength >= I2C_BUFFER_LENGTH)
+        return 0;
+    txBuffer[txLength++] = data;
+    return 1;
+}
+
+size_t TwoWire::write(const uint8_t *data, size_t length)
+{
+    size_t n = 0;
+    while (n < length && write(data[n]))
+        n++;
+    return n;
+}
+
+// 0 = sent, 2 = nothing acknowledged the address
+uint8_t TwoWire::endTransmission(bool sendStop)
+{
+    HostI2CDevice *device = devices()[txAddress];
+
+    if (!device)
+        return 2;
+    device->receive(txBuffer, txLength);
+    txLength = 0;
+    return 0;
+}
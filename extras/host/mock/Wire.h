@@ -0,0 +1,42 @@
+// Host stand-in for the Arduino Wire library.  Transactions are delivered, whole, to whatever
+// simulated device is attached at their address (see HostHD44780).
+#ifndef HOST_WIRE_H
+#define HOST_WIRE_H
+
+#include <Arduino.h>
+
+// As the ESP32 core
+#define I2C_BUFFER_LENGTH 128
+
+// Something on the simulated bus (see TwoWire::attach())
+class HostI2CDevice
+{
+public:
+    virtual ~HostI2CDevice() {}
+    virtual void receive(const uint8_t *data, int length) = 0;
+};
+
+class TwoWire
+{
+protected:
+    uint8_t txAddress = 0;
+    uint8_t txBuffer[I2C_BUFFER_LENGTH];
+    int txLength = 0;
+
+public:
+    bool begin() { return true; }
+    bool begin(int sda, int scl, uint32_t frequency = 0) { return true; }
+    void setClock(uint32_t frequency) {}
+    void beginTransmission(uint8_t address);
+    size_t write(uint8_t data);
+    size_t write(const uint8_t *data, size_t length);
+    uint8_t endTransmission(bool sendStop = true);
+
+    // Simulation helper
+    static void attach(uint8_t address, HostI2CDevice *device);
+};
+
+extern TwoWire Wire;
+extern TwoWire Wire1; // (The ESP32's second I2C controller)
+
+#endif // HOST_WIRE_H
@@ -0,0 +1,24 @@
+// Host stand-in for the (ESP-IDF) FreeRTOS API used by the library - tasks are std::threads,
+// so the render task can be exercised (and run under ThreadSanitizer) on Linux
+#ifndef HOST_FREERTOS_H
+#define HOST_FREERTOS_H
+
+#include <stdint.h>
+
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+typedef uint32_t TickType_t;
+typedef void (*TaskFunction_t)(void *);
+
+#define pdTRUE 1
+#define pdFALSE 0
+#define pdPASS pdTRUE
+#define pdFAIL pdFALSE
+#define portMAX_DELAY ((TickType_t)0xFFFFFFFF)
+#define tskNO_AFFINITY 0x7FFFFFFF
+
+// 1 tick = 1ms
+#define configTICK_RATE_HZ 1000
+#define pdMS_TO_TICKS(ms) ((TickType_t)(ms))
+
+#endif // HOST_FREERTOS_H
@@ -0,0 +1,264 @@
+// Exercises two MenuContexts at once: the default one on a 20 x 4 display, and a second on a 16 x 2
+// display (on the second I2C bus), each with its own encoders & menus.  Each is driven by a thread of
+// its own (random turns & presses, then poll(), as a task would) with its own render task, while an
+// "application" thread reads the values of both.  Afterwards, each display must match its frame, and
+// focus must return the way it came - including from an item which is in two of a context's menus,
+// and from a MenuDynamic with no entries.
+// Run it with `make stress`, or `make tsan` to check that the contexts don't share anything unguarded.
+
+#include <Arduino.h>
+#include <Wire.h>
+#include <DualEncoderMenuSystem.h>
+#include <atomic>
+#include <random>
+#include <thread>
+
+#define RUN_MILLIS 2000
+
+LiquidCrystal_I2C lcd(0x27, 20, 4);
+LiquidCrystal_I2C panelLcd(0x26, 16, 2); // (Only to look at the second display)
+MenuPCF8574Transport display(0x27);
+MenuPCF8574Transport panelDisplay(0x26, Wire1);
+RotaryEncoder aEncoder(21, 22, 23);
+RotaryEncoder bEncoder(32, 33, 34);
+RotaryEncoder cEncoder(25, 26, 27);
+RotaryEncoder dEncoder(12, 13, 14);
+MenuContext panel;
+
+// The default context's menus - Speed is in both of them
+bool enabled = false;
+long speed = 1000;
+long diameter = 355;
+long volume = 50;
+int mode = 0;
+int colour = 0;
+
+MenuBoolValue mmEnabled(MenuLabel("Enabled"), MenuOption("Yes"), MenuOption("No"), &enabled);
+MenuLongValue mmSpeed(MenuLabel("Speed"), MenuLabel("rpm"), 0, 2000, 100, 10, &speed);
+MenuFixedValue mmDiameter(MenuLabel("Diameter"), MenuLabel("mm"), 3, 50, 2000, 50, 1, &diameter);
+MenuLongValue cfgVolume(MenuLabel("Volume"), MenuLabel("%"), 0, 100, 10, 1, &volume);
+// No profiles have been stored yet
+class NoProfiles : public MenuItemGenerator
+{
+public:
+    int count() override { return 0; }
+    MenuSystem *build(int index, MenuItemSlot &slot) override { return nullptr; }
+} noProfiles;
+MenuDynamic cfgProfiles(MenuLabel("Profiles"), &noProfiles);
+MENU_ITEMS(cfgItems, &cfgVolume, &mmSpeed, &cfgProfiles);
+Menu cfgMenu(MenuLabel("Configuration"), cfgItems);
+static int modeCount() { return 12; }
+static void modeText(int index, char *text, size_t size) { snprintf(text, size, "Mode %d", index + 1); }
+MenuDropDownListValue mmMode(MenuLabel("Mode"), modeCount, modeText, &mode);
+MENU_LIST(colours, "Red", "Green", "Blue");
+MenuRotaryListValue mmColour(MenuLabel("Colour"), colours, &colour);
+MENU_ITEMS(mainItems, &mmEnabled, &mmSpeed, &mmDiameter, &cfgMenu, &mmMode, &mmColour);
+Menu mainMenu(MenuLabel("Main Menu"), mainItems);
+
+// The panel's menus - Feed is in both of them
+long feed = 200;
+float ratio = 1.5;
+bool pump = true;
+long level = 5;
+int pattern = 0;
+
+MenuLongValue pnFeed(MenuLabel("Feed"), MenuLabel("mm/s"), 0, 500, 10, 1, &feed);
+MenuFloatValue pnRatio(MenuLabel("Ratio"), MenuLabel(""), 0.5, 4.0, 0.1, 0.01, &ratio);
+MenuBoolValue pnPump(MenuLabel("Pump"), MenuOption("On"), MenuOption("Off"), &pump);
+MenuLongValue setLevel(MenuLabel("Level"), MenuLabel(""), 0, 9, 1, 1, &level);
+MENU_ITEMS(setupItems, &setLevel, &pnFeed);
+Menu setupMenu(MenuLabel("Setup"), setupItems);
+static int patternCount() { return 20; }
+static void patternText(int index, char *text, size_t size) { snprintf(text, size, "Pattern %c", 'A' + index); }
+MenuDropDownListValue pnPattern(MenuLabel("Pattern"), patternCount, patternText, &pattern);
+MENU_ITEMS(panelItems, &pnFeed, &pnRatio, &pnPump, &setupMenu, &pnPattern);
+Menu panelMenu(MenuLabel("Panel"), panelItems);
+
+static std::atomic<bool> running(true);
+static unsigned long changes[2];
+
+static void speedChanged(MenuSystem *item) { changes[0]++; }
+static void feedChanged(MenuSystem *item) { changes[1]++; }
+
+// One context's task: random input, then a poll() - so its items & callbacks run on this thread only
+static void session(MenuContext &context, RotaryEncoder &a, RotaryEncoder &b, unsigned seed, unsigned long &polls)
+{
+    std::minstd_rand rng(seed);
+
+    while (running)
+    {
+        RotaryEncoder &encoder = rng() % 2 ? a : b;
+        if (rng() % 8)
+            encoder.turn(rng() % 2);
+        else
+            encoder.press();
+        context.poll();
+        polls++;
+        std::this_thread::sleep_for(std::chrono::microseconds(rng() % 400));
+    }
+}
+
+static unsigned long badReads = 0;
+
+static void application()
+{
+    while (running)
+    {
+        {
+            MenuLock lock; // The default context
+            if (speed < 0 || speed > 2000 || diameter < 50 || diameter > 2000 || volume < 0 || volume > 100)
+                badReads++;
+        }
+        {
+            MenuLock lock(panel);
+            if (feed < 0 || feed > 500 || ratio < 0.5 || ratio > 4.0 || level < 0 || level > 9)
+                badReads++;
+        }
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+}
+
+static void turn(MenuContext &context, RotaryEncoder &encoder, int detents)
+{
+    for (; detents; detents += detents > 0 ? -1 : 1)
+        encoder.turn(detents > 0);
+    context.poll();
+}
+
+static void press(MenuContext &context, RotaryEncoder &encoder)
+{
+    encoder.press();
+    context.poll();
+}
+
+// Open shared (entry sharedIndex of sub, entry subIndex of root) from sub, then from root: each time,
+// a press must return focus to the menu it was opened from.  Menus open where they were left, so
+// each selection is first taken back to the top (the root's first item, or sub's return entry).
+static bool returnPath(MenuContext &context, RotaryEncoder &encoder, Menu &root, Menu &sub, int subIndex, MenuSystem &shared, int sharedIndex, int rootIndex)
+{
+    bool ok = true;
+
+    context.start(&root);
+    turn(context, encoder, -100);
+    turn(context, encoder, subIndex);
+    press(context, encoder);
+    turn(context, encoder, -100);
+    turn(context, encoder, sharedIndex + 1);
+    press(context, encoder);
+    ok &= context.current() == &shared && context.parentOf(&shared) == &sub;
+    press(context, encoder);
+    ok &= context.current() == &sub;
+    turn(context, encoder, -10); // To the return entry
+    press(context, encoder);
+    ok &= context.current() == &root;
+    turn(context, encoder, rootIndex - subIndex);
+    press(context, encoder);
+    ok &= context.current() == &shared && context.parentOf(&shared) == &root;
+    press(context, encoder);
+    ok &= context.current() == &root;
+    return ok;
+}
+
+// Open empty (entry emptyIndex of sub, entry subIndex of root): it has nothing but its return entry to
+// select, so turns (of either encoder, either way) must leave focus in it, and a press return it to sub
+static bool emptyPath(MenuContext &context, RotaryEncoder &a, RotaryEncoder &b, Menu &root, Menu &sub, int subIndex, Menu &empty, int emptyIndex)
+{
+    bool ok = true;
+
+    context.start(&root);
+    turn(context, a, -100);
+    turn(context, a, subIndex);
+    press(context, a);
+    turn(context, a, -100);
+    turn(context, a, emptyIndex + 1);
+    press(context, a);
+    ok &= context.current() == &empty;
+    turn(context, a, 3);
+    turn(context, a, -3);
+    turn(context, b, 2);
+    turn(context, b, -5);
+    ok &= context.current() == &empty;
+    press(context, a);
+    ok &= context.current() == &sub;
+    return ok;
+}
+
+int main()
+{
+    unsigned long polls[2] = {};
+    int failures = 0;
+
+    Wire.begin();
+    Wire1.begin();
+    MenuSystem::begin(20, 4, &display, &aEncoder, &bEncoder);
+    panel.begin(16, 2, &panelDisplay, &cEncoder, &dEncoder);
+    mmSpeed.onChange(speedChanged);
+    pnFeed.onChange(feedChanged);
+    mmSpeed.setAcceleration();
+    pnFeed.setAcceleration();
+    mainMenu.takeFocus();
+    panel.start(&panelMenu);
+    MenuSystem::setRenderLimits(50, 128);
+    panel.setRenderLimits(40, 64);
+    if (!MenuSystem::startRenderTask(0) || !panel.startRenderTask(1))
+    {
+        printf("FAIL: render tasks didn't start\n");
+        return 1;
+    }
+
+    std::thread mainThread(session, std::ref(MenuContext::primary), std::ref(aEncoder), std::ref(bEncoder), 1, std::ref(polls[0]));
+    std::thread panelThread(session, std::ref(panel), std::ref(cEncoder), std::ref(dEncoder), 2, std::ref(polls[1]));
+    std::thread applicationThread(application);
+    delay(RUN_MILLIS);
+    running = false;
+    mainThread.join();
+    panelThread.join();
+    applicationThread.join();
+    MenuSystem::poll();
+    panel.poll();
+    MenuSystem::stopRenderTask();
+    panel.stopRenderTask();
+
+    // Each render task sends everything drawn before it stops, so each display should now match its frame
+    lcd.resetStats();
+    panelLcd.resetStats();
+    MenuSystem::flush();
+    panel.flush();
+    printf("Default context: %lu polls, %lu events, %lu onChange() calls\n", polls[0], MenuSystem::getStats().events, changes[0]);
+    printf("Panel context:   %lu polls, %lu events, %lu onChange() calls\n", polls[1], panel.stats.events, changes[1]);
+    if (lcd.stats.characters || panelLcd.stats.characters || badReads)
+    {
+        printf("FAIL: %lu + %lu characters still to send after the render tasks stopped, %lu bad reads\n",
+               lcd.stats.characters, panelLcd.stats.characters, badReads);
+        failures++;
+    }
+
+    // Now single threaded (poll() draws), check the way back from each context's shared item
+    if (!returnPath(MenuContext::primary, aEncoder, mainMenu, cfgMenu, 3, mmSpeed, 1, 1))
+    {
+        printf("FAIL: the default context's Speed didn't return focus the way it came\n");
+        failures++;
+    }
+    if (!returnPath(panel, cEncoder, panelMenu, setupMenu, 3, pnFeed, 1, 0))
+    {
+        printf("FAIL: the panel's Feed didn't return focus the way it came\n");
+        failures++;
+    }
+    if (!emptyPath(MenuContext::primary, aEncoder, bEncoder, mainMenu, cfgMenu, 3, cfgProfiles, 2))
+    {
+        printf("FAIL: the default context's empty Profiles menu couldn't be left\n");
+        failures++;
+    }
+    char row[17];
+    panel.flush(); // (The render limits may have held some of it back)
+    panelLcd.frameRow(0, row);
+    if (strncmp(row, "Panel ", 6))
+    {
+        printf("FAIL: the panel shows \"%s\" rather than its main menu\n", row);
+        failures++;
+    }
+    if (failures)
+        return 1;
+    printf("OK\n");
+    return 0;
+}
@@ -0,0 +1,115 @@
+// Exercises MenuSystem::startRenderTask().  An "encoder" thread generates random turns & presses
+// (as the encoder interrupts would), loop() polls for them, and an "application" thread reads the
+// values being edited (holding a MenuLock), while the render task sends frames to the display.
+// Run it with `make stress`, or `make tsan` to run it under ThreadSanitizer.
+
+#include <Arduino.h>
+#include <Wire.h>
+#include <DualEncoderMenuSystem.h>
+#include <atomic>
+#include <random>
+#include <thread>
+
+#define RUN_MILLIS 2000
+
+LiquidCrystal_I2C lcd(0x27, 20, 4);
+MenuPCF8574Transport display(0x27);
+RotaryEncoder aEncoder(21, 22, 23);
+RotaryEncoder bEncoder(32, 33, 34);
+
+bool enabled = false;
+long speed = 1000;
+long diameter = 355;
+int mode = 0;
+int colour = 0;
+long volume = 50;
+
+MenuBoolValue mmEnabled(MenuLabel("Enabled"), MenuOption("Yes"), MenuOption("No"), &enabled);
+MenuLongValue mmSpeed(MenuLabel("Speed"), MenuLabel("rpm"), 0, 2000, 100, 10, &speed);
+MenuFixedValue mmDiameter(MenuLabel("Diameter"), MenuLabel("mm"), 3, 50, 2000, 50, 1, &diameter);
+MENU_LIST(modes, "Automatic", "Manual", "Test");
+MenuDropDownListValue mmMode(MenuLabel("Mode"), modes, &mode);
+MENU_LIST(colours, "Red", "Green", "Blue");
+MenuRotaryListValue mmColour(MenuLabel("Colour"), colours, &colour);
+MenuLongValue cfgVolume(MenuLabel("Volume"), MenuLabel("%"), 0, 100, 10, 1, &volume);
+MENU_ITEMS(cfgItems, &cfgVolume, &mmSpeed);
+Menu cfgMenu(MenuLabel("Configuration"), cfgItems);
+MENU_ITEMS(mainItems, &mmEnabled, &mmSpeed, &mmDiameter, &cfgMenu, &mmMode, &mmColour);
+Menu mainMenu(MenuLabel("Main Menu"), mainItems);
+
+static std::atomic<bool> running(true);
+
+static void encoders()
+{
+    std::minstd_rand rng(1);
+
+    while (running)
+    {
+        RotaryEncoder &encoder = rng() % 2 ? aEncoder : bEncoder;
+        if (rng() % 8)
+            encoder.turn(rng() % 2);
+        else
+            encoder.press();
+        std::this_thread::sleep_for(std::chrono::microseconds(rng() % 400));
+    }
+}
+
+static unsigned long badReads = 0;
+
+static void application()
+{
+    while (running)
+    {
+        {
+            MenuLock lock; // So the values can't change while we use them
+            if (speed < 0 || speed > 2000 || diameter < 50 || diameter > 2000 || volume < 0 || volume > 100)
+                badReads++;
+        }
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+}
+
+int main()
+{
+    unsigned long polls = 0;
+
+    Wire.begin();
+    MenuSystem::begin(20, 4, &display, &aEncoder, &bEncoder);
+    mainMenu.takeFocus();
+    MenuSystem::setRenderLimits(50, 128); // So the task also has frames to hold back & finish later
+    if (!MenuSystem::startRenderTask(0))
+    {
+        printf("FAIL: render task didn't start\n");
+        return 1;
+    }
+
+    std::thread encoderThread(encoders);
+    std::thread applicationThread(application);
+    unsigned long start = millis();
+    while (millis() - start < RUN_MILLIS)
+    {
+        MenuSystem::poll(); // loop()
+        polls++;
+        delayMicroseconds(500);
+    }
+    running = false;
+    encoderThread.join();
+    applicationThread.join();
+    MenuSystem::poll();
+    MenuSystem::stopRenderTask();
+
+    // The task sends everything drawn before it stops, so the display should now match the frame
+    lcd.resetStats();
+    MenuSystem::flush();
+    const MenuSystemStats &stats = MenuSystem::getStats();
+    printf("%lu polls, %lu events (%lu dropped), %lu frames sent, latency us min/avg/max %lu/%lu/%lu\n", polls, stats.events,
+           MenuSystem::queueOverflows(), stats.flushes, stats.latencyMin,
+           stats.events ? (unsigned long)(stats.latencyTotal / stats.events) : 0, stats.latencyMax);
+    if (lcd.stats.characters || badReads)
+    {
+        printf("FAIL: %lu characters still to send after the render task stopped, %lu bad reads\n", lcd.stats.characters, badReads);
+        return 1;
+    }
+    printf("OK\n");
+    return 0;
+}
@@ -0,0 +1,160 @@
+// Exercises the settings store (MenuSystem::beginSettings()) on a file standing in for flash.
+// Random editing sessions are played through the encoders; every few sessions the "power is cycled"
+// (the values are scrambled & restored from the file), sometimes with the power going part way
+// through the write.  Each restore must give back what was committed (or, after a failed write,
+// what was there before it), and the sectors must have been erased about as often as each other.  Run it with `make stress`.
+
+#include <Arduino.h>
+#include <Wire.h>
+#include <DualEncoderMenuSystem.h>
+#include <HostFileStorage.h>
+#include <random>
+
+#define SESSIONS 3000
+#define SECTOR_SIZE 256
+#define SECTOR_COUNT 4
+#define COMMIT_DELAY 20
+#define SETTINGS_FILE "/tmp/menu_settings_stress.bin"
+
+LiquidCrystal_I2C lcd(0x27, 16, 2);
+RotaryEncoder aEncoder(21, 22, 23);
+RotaryEncoder bEncoder(32, 33, 34);
+
+struct Values
+{
+    long speed = 1000;
+    float ratio = 1.5;
+    long diameter = 355;
+    bool enabled = false;
+    int mode = 0;
+    long offset = 0;
+
+    bool operator==(const Values &other) const
+    {
+        return speed == other.speed && ratio == other.ratio && diameter == other.diameter && enabled == other.enabled && mode == other.mode &&
+               offset == other.offset;
+    }
+};
+Values values;
+volatile int32_t diameterSteps = 0;
+
+MenuLongValue mmSpeed(MenuLabel("Speed"), MenuLabel("rpm"), 0, 2000, 100, 10, &values.speed);
+MenuFloatValue mmRatio(MenuLabel("Ratio"), MenuLabel(""), 0.5, 4.0, 0.1, 0.01, &values.ratio);
+MenuFixedValue mmDiameter(MenuLabel("Diameter"), MenuLabel("mm"), 3, 50, 2000, 50, 1, &values.diameter);
+MenuBoolValue mmEnabled(MenuLabel("Enabled"), MenuOption("Yes"), MenuOption("No"), &values.enabled);
+MENU_LIST(modes, "Automatic", "Manual", "Test");
+MenuDropDownListValue mmMode(MenuLabel("Mode"), modes, &values.mode);
+MenuLongValue mmOffset(MenuLabel("Offset"), MenuLabel("steps"), 0, 0, 100, 1, &values.offset); // No limits - goes -ve
+MENU_ITEMS(mainItems, &mmSpeed, &mmRatio, &mmDiameter, &mmEnabled, &mmMode, &mmOffset);
+Menu mainMenu(MenuLabel("Main Menu"), mainItems);
+
+static void event(RotaryEncoder &encoder, int turn)
+{
+    if (turn)
+        encoder.turn(turn > 0);
+    else
+        encoder.press();
+    MenuSystem::poll();
+}
+
+// Power up again on storage, with the values scrambled first - returns what was restored
+static Values powerCycle(MenuStorage &storage)
+{
+    values.speed = -1;
+    values.ratio = -1;
+    values.diameter = -1;
+    values.enabled = !values.enabled;
+    values.mode = -1;
+    values.offset = 12345;
+    if (!MenuSystem::beginSettings(&storage, COMMIT_DELAY))
+        printf("FAIL: beginSettings() failed\n");
+    return values;
+}
+
+int main()
+{
+    HostFileStorage storage(SETTINGS_FILE, SECTOR_SIZE, SECTOR_COUNT);
+    std::minstd_rand rng(1);
+    unsigned long edits = 0, cycles = 0, powerFailures = 0, failures = 0;
+
+    storage.format();
+    Wire.begin();
+    MenuSystem::begin(16, 2, &lcd, &aEncoder, &bEncoder);
+    mmSpeed.persist(1);
+    mmRatio.persist(2);
+    mmDiameter.persist(3);
+    mmEnabled.persist(4);
+    mmMode.persist(5);
+    mmOffset.persist(6);
+    mmDiameter.publishTo(&diameterSteps);
+    MenuSystem::beginSettings(&storage, COMMIT_DELAY);
+    mainMenu.takeFocus();
+
+    for (int session = 0; session < SESSIONS; session++)
+    {
+        Values before = values;
+        bool cutPower = rng() % 20 == 0;
+
+        // Select an item & edit it
+        for (int i = 0; i < 6; i++)
+            event(aEncoder, -1);
+        for (int i = rng() % 6; i > 0; i--)
+            event(aEncoder, 1);
+        event(aEncoder, 0);
+        for (int i = rng() % 6; i >= 0; i--, edits++)
+            event(rng() % 2 ? aEncoder : bEncoder, rng() % 2 ? 1 : -1);
+        if (rng() % 50 == 0)
+        {
+            delay(COMMIT_DELAY + 5); // A long edit: it's committed while the editor is still open
+            MenuSystem::poll();
+        }
+        if (cutPower)
+            storage.failAfter(rng() % 16);
+        event(aEncoder, 0); // The editor returns focus, and the change is committed
+        Values after = values;
+
+        if (cutPower || rng() % 10 == 0)
+        {
+            HostFileStorage restarted(SETTINGS_FILE, SECTOR_SIZE, SECTOR_COUNT);
+            Values restored = powerCycle(restarted);
+            cycles++;
+            if (cutPower)
+                powerFailures++;
+            if (!(restored == after) && !(cutPower && restored == before))
+            {
+                printf("FAIL: session %d (cut %d): restored speed %ld ratio %g diameter %ld enabled %d mode %d offset %ld\n", session, cutPower,
+                       restored.speed, restored.ratio, restored.diameter, restored.enabled, restored.mode, restored.offset);
+                printf("  before %ld %g %ld %d %d %ld, after %ld %g %ld %d %d %ld\n", before.speed, before.ratio, before.diameter, before.enabled, before.mode, before.offset,
+                       after.speed, after.ratio, after.diameter, after.enabled, after.mode, after.offset);
+                failures++;
+            }
+            if (diameterSteps != restored.diameter)
+            {
+                printf("FAIL: session %d: published diameter %ld, restored %ld\n", session, (long)diameterSteps, restored.diameter);
+                failures++;
+            }
+            MenuSystem::beginSettings(&storage, COMMIT_DELAY); // Carry on with the first storage (its erase counts)
+            storage.failAfter(-1);
+            mainMenu.takeFocus();
+        }
+    }
+
+    unsigned long fewest = storage.erases[0], most = storage.erases[0];
+    printf("%d sessions, %lu edits: %lu writes (%lu bytes), %lu power cycles (%lu mid-write)\n",
+           SESSIONS, edits, storage.writes, storage.bytesWritten, cycles, powerFailures);
+    printf("Sector erases:");
+    for (unsigned long erases : storage.erases)
+    {
+        printf(" %lu", erases);
+        fewest = min(fewest, erases);
+        most = max(most, erases);
+    }
+    printf("\n");
+    if (failures || most > 2 * fewest) // (A sector whose rewrite the power cut short is erased again)
+    {
+        printf("FAIL: %lu bad restores, sector erases %lu to %lu\n", failures, fewest, most);
+        return 1;
+    }
+    printf("OK\n");
+    return 0;
+}
@@ -1,19 +1,18 @@
 #include "DualEncoderMenuSystem.h"
+#include <limits.h>
 
 // Define static members
-int MenuSystem::dispHeight = 0;
-int MenuSystem::dispWidth = 0;
-LiquidCrystal_I2C *MenuSystem::lcd = nullptr;
-RotaryEncoder *MenuSystem::encoderA = nullptr;
-RotaryEncoder *MenuSystem::encoderB = nullptr;
+MenuContext MenuContext::primary;
+MenuContext *MenuContext::settingsContext = nullptr;
+thread_local MenuContext *MenuContext::bound = nullptr;
+MenuContext *MenuContext::slots[MENU_SYSTEM_MAX_CONTEXTS] = {};
+MenuSettings MenuSystem::settings;
+const char *const menuItemTypeNames[] = {"MenuSystem", "Menu", "MenuAction", "MenuBoolValue", "MenuLongValue", "MenuFloatValue", "MenuDropDownListValue", "MenuRotaryListValue", "MenuFixedValue", "MenuWatchValue", "MenuDashboard", "MenuDynamic"};
 
-bool MenuSystem::initialised = false;
-MenuSystem *currentMenu = nullptr;
-
-char *naStr = (char *)"N/A";
+const char *naStr = "N/A";
 char selectionChar = '>';
 
-byte returnSymbol[] = {
+const uint8_t returnSymbol[] = {
     0b00100,
     0b01110,
     0b11111,
@@ -23,7 +22,7 @@ byte returnSymbol[] = {
     0b00000,
     0b00000}; // Custom character for return type indicator
 
-byte enterSymbol[] = {
+const uint8_t enterSymbol[] = {
     0b00000,
     0b00000,
     0b11100,
@@ -33,7 +32,7 @@ byte enterSymbol[] = {
     0b01110,
     0b00100}; // Custom character for enter type indicator
 
-byte rotateSymbol[] = {
+const uint8_t rotateSymbol[] = {
     0b00100,
     0b00010,
     0b11111,
@@ -43,7 +42,7 @@ byte rotateSymbol[] = {
     0b00100,
     0b00000}; // Custom character for rotary list type indicator
 
-byte sparkSymbol[] = {
+const uint8_t sparkSymbol[] = {
     0b00001,
     0b00010,
     0b00100,
@@ -53,83 +52,720 @@ byte sparkSymbol[] = {
     0b01000,
     0b10000}; // Custom character for action/function type indicator
 
+// Indexed by symbol character - 1 (see MenuContext::symbol())
+const uint8_t *menuSymbols[] = {returnSymbol, enterSymbol, rotateSymbol, sparkSymbol};
+
+// The encoder library calls a plain function, which can't be told which context it's for - so each
+// context begun takes one of MENU_SYSTEM_MAX_CONTEXTS slots, each with a set of callbacks of its own
+struct MenuEncoderCallbacks
+{
+    void (*aTurned)(long value);
+    void (*aPressed)(unsigned long value);
+    void (*bTurned)(long value);
+    void (*bPressed)(unsigned long value);
+};
+
+static_assert(MENU_SYSTEM_MAX_CONTEXTS >= 1 && MENU_SYSTEM_MAX_CONTEXTS <= 4, "MENU_SYSTEM_MAX_CONTEXTS must be from 1 to 4");
+
+#define MENU_ENCODER_CALLBACKS(slot) {&turned<slot, ENCODER_SOURCE::A>, &pressed<slot, ENCODER_SOURCE::A>, &turned<slot, ENCODER_SOURCE::B>, &pressed<slot, ENCODER_SOURCE::B>}
+
+// The default context's callbacks, for sketches which register them with the encoders themselves
 void MenuSystem::encoderAturned(long value)
 {
-    if (currentMenu)
-        currentMenu->inputHandler(ENCODER_SOURCE::A, ENCODER_EVENT::TURNED, value);
+    MenuContext::primary.events.push(ENCODER_SOURCE::A, ENCODER_EVENT::TURNED, value);
 }
 
 void MenuSystem::encoderApressed(unsigned long value)
 {
-    if (currentMenu)
-        currentMenu->inputHandler(ENCODER_SOURCE::A, ENCODER_EVENT::PRESSED, value);
+    MenuContext::primary.events.push(ENCODER_SOURCE::A, ENCODER_EVENT::PRESSED, value);
 }
 
 void MenuSystem::encoderBturned(long value)
 {
-    if (currentMenu)
-        currentMenu->inputHandler(ENCODER_SOURCE::B, ENCODER_EVENT::TURNED, value);
+    MenuContext::primary.events.push(ENCODER_SOURCE::B, ENCODER_EVENT::TURNED, value);
 }
 
 void MenuSystem::encoderBpressed(unsigned long value)
 {
-    if (currentMenu)
-        currentMenu->inputHandler(ENCODER_SOURCE::B, ENCODER_EVENT::PRESSED, value);
+    MenuContext::primary.events.push(ENCODER_SOURCE::B, ENCODER_EVENT::PRESSED, value);
 }
 
-void MenuSystem::begin(int displayWidth, int displayHeight, LiquidCrystal_I2C *display, RotaryEncoder *Aencoder, RotaryEncoder *Bencoder)
+MenuContext::MenuContext() : frameInterval(frameMillis(MENU_SYSTEM_MAX_FPS)), frameBudget(MENU_SYSTEM_FRAME_BYTE_BUDGET)
+{
+}
+
+// Pass delta detents of one encoder, the last of them turned at time (micros()), to the item with focus
+void MenuContext::dispatchTurn(ENCODER_SOURCE source, long delta, unsigned long time)
+{
+    MenuSystem *item = current();
+
+    turnTime = time;
+    if (item && delta)
+        item->turnHandler(source, delta);
+}
+
+// Call this regularly from loop() (or from the task which runs this context).  Handles all queued
+// encoder input, then updates the LCD once with the combined result.  Consecutive turns of the same
+// encoder are merged into a single signed delta, so a fast spin costs one value update & one redraw.
+// With a render task running, the LCD update is left to the task.  Any of the frame held back
+// by the render limits (see setRenderLimits()) goes out on a later poll().
+void MenuContext::poll()
+{
+    Use use(*this);
+    MenuLock lock(*this);
+    MenuEvent event;
+    ENCODER_SOURCE turnSource = ENCODER_SOURCE::A;
+    long turnDelta = 0;
+    unsigned long turnAt = 0;
+    int pending = events.depth(); // Don't let a fast-spinning encoder keep us here forever
+
+    while (pending-- > 0 && events.pop(event))
+    {
+#if MENU_SYSTEM_STATS
+        if (!batchCount++)
+            batchFirst = event.time;
+        batchLast = event.time;
+        batchOffsets += event.time - batchFirst;
+#endif
+        if (event.event == ENCODER_EVENT::TURNED)
+        {
+            if (turnDelta && event.source != turnSource)
+            {
+                dispatchTurn(turnSource, turnDelta, turnAt);
+                turnDelta = 0;
+            }
+            turnSource = (ENCODER_SOURCE)event.source;
+            turnAt = event.time;
+            turnDelta += event.value == 1 ? 1 : -1;
+        }
+        else
+        {
+            dispatchTurn(turnSource, turnDelta, turnAt);
+            turnDelta = 0;
+            if (MenuSystem *item = current())
+                item->inputHandler((ENCODER_SOURCE)event.source, (ENCODER_EVENT)event.event, event.value);
+        }
+    }
+    dispatchTurn(turnSource, turnDelta, turnAt);
+    MenuValueNotifier::deliver(changes); // onChange() callbacks, now the values have settled
+    if (settingsContext == this)
+        MenuSystem::settings.service(current()); // Store the persisted values which have been changed
+    if (MenuSystem *item = current())
+        item->refresh(); // Live values which have changed
+    if (renderTask.running())
+        renderTask.wake();
+    else
+        render(false);
+}
+
+// Send the frame to the LCD - within the render limits, unless all is set - then, once it's all
+// there, record how long the input it shows took to get there.  Returns the ms until the rest of
+// the frame can be sent, or 0 if the LCD is up to date.
+uint32_t MenuContext::render(bool all)
+{
+    Use use(*this);
+    MenuLock lock(*this);
+    unsigned long sinceLast = millis() - lastFrame;
+
+    if (all || !frameInterval || sinceLast >= frameInterval)
+    {
+        if (sendFrame(all ? 0 : frameBudget))
+            lastFrame = millis();
+        sinceLast = 0;
+    }
+    if (!displayUpToDate())
+        return max(frameInterval - sinceLast, 1UL);
+#if MENU_SYSTEM_STATS
+    if (batchCount)
+    {
+        unsigned long now = micros();
+        if (!stats.events || now - batchLast < stats.latencyMin)
+            stats.latencyMin = now - batchLast;
+        if (now - batchFirst > stats.latencyMax)
+            stats.latencyMax = now - batchFirst;
+        stats.latencyTotal += (unsigned long long)(now - batchFirst) * batchCount - batchOffsets;
+        stats.events += batchCount;
+        batchCount = 0;
+        batchOffsets = 0;
+    }
+#endif
+    return 0;
+}
+
+// (For the render task)
+uint32_t MenuContext::renderFrom(MenuContext *context, bool all)
+{
+    return context->render(all);
+}
+
+// Limit how often, and how much of, the frame is sent to the LCD (0 = no limit, the default - see
+// MENU_SYSTEM_MAX_FPS & MENU_SYSTEM_FRAME_BYTE_BUDGET).  A fast spin then costs at most
+// maxFramesPerSecond frames, and no frame holds the I2C bus for longer than frameByteBudget bytes
+// (about 22us each at 400kHz, as estimated by the transport) - whatever doesn't fit is sent in the
+// following frames, oldest rows first, so nothing is starved.  flush() ignores the limits.
+void MenuContext::setRenderLimits(unsigned int maxFramesPerSecond, unsigned int frameByteBudget)
+{
+    MenuLock lock(*this);
+
+    frameInterval = frameMillis(maxFramesPerSecond);
+    frameBudget = frameByteBudget;
+    renderTask.wake(); // So it picks up the new limits
+}
+
+void MenuContext::begin(int displayWidth, int displayHeight, LiquidCrystal_I2C *display, RotaryEncoder *Aencoder, RotaryEncoder *Bencoder)
+{
+    liquidCrystalTransport = MenuLiquidCrystalTransport(display);
+    begin(displayWidth, displayHeight, display ? &liquidCrystalTransport : nullptr, Aencoder, Bencoder);
+}
+
+// Use this form to drive the display through a transport other than LiquidCrystal_I2C (e.g. MenuPCF8574Transport)
+void MenuContext::begin(int displayWidth, int displayHeight, MenuDisplayTransport *display, RotaryEncoder *Aencoder, RotaryEncoder *Bencoder)
 {
-    dispWidth = displayWidth;
-    dispHeight = displayHeight;
+    static const MenuEncoderCallbacks callbacks[] = {
+        MENU_ENCODER_CALLBACKS(0),
+#if MENU_SYSTEM_MAX_CONTEXTS > 1
+        MENU_ENCODER_CALLBACKS(1),
+#endif
+#if MENU_SYSTEM_MAX_CONTEXTS > 2
+        MENU_ENCODER_CALLBACKS(2),
+#endif
+#if MENU_SYSTEM_MAX_CONTEXTS > 3
+        MENU_ENCODER_CALLBACKS(3),
+#endif
+    };
+
+    // Any HD44780 geometry up to MENU_SYSTEM_MAX_COLS x MENU_SYSTEM_MAX_ROWS (the value editors need at least 2 rows)
+    dispWidth = constrain(displayWidth, MENU_SYSTEM_MIN_COLS, MENU_SYSTEM_MAX_COLS);
+    dispHeight = constrain(displayHeight, 2, MENU_SYSTEM_MAX_ROWS);
     lcd = display;
     encoderA = Aencoder;
     encoderB = Bencoder;
 
-    if (!lcd || !encoderA || !encoderB)
-        return; // Can't initialise without these
-
-    encoderA->onTurned(&MenuSystem::encoderAturned);
-    encoderA->onPressed(&MenuSystem::encoderApressed);
-    encoderB->onTurned(&MenuSystem::encoderBturned);
-    encoderB->onPressed(&MenuSystem::encoderBpressed);
-    lcd->init();
-    lcd->backlight();
-    lcd->createChar(1, returnSymbol);
-    lcd->createChar(2, enterSymbol);
-    lcd->createChar(3, rotateSymbol);
-    lcd->createChar(4, sparkSymbol);
+    for (int i = 0; slot < 0 && i < MENU_SYSTEM_MAX_CONTEXTS; i++)
+        if (!slots[i])
+        {
+            slots[i] = this;
+            slot = i;
+        }
+    if (!lcd || !encoderA || !encoderB || slot < 0)
+        return; // Can't initialise without these (or once every slot has been taken)
+
+    encoderA->onTurned(callbacks[slot].aTurned);
+    encoderA->onPressed(callbacks[slot].aPressed);
+    encoderB->onTurned(callbacks[slot].bTurned);
+    encoderB->onPressed(callbacks[slot].bPressed);
+    lcd->begin(dispWidth, dispHeight);
     lcd->setCursor(0, 0);
+    glyphs.begin(); // Custom characters are loaded as they're needed (see glyph())
+    frame.begin(dispWidth, dispHeight);
+    frame.markCleared(); // lcd->begin() cleared it
 
     initialised = true;
+#if MENU_SYSTEM_FOOTPRINT_REPORT
+    printFootprint();
+#endif
 }
 
-MenuSystem::MenuSystem(const char *dispText)
+// Give item focus in this context (e.g. its main menu, from setup()) - the same as
+// item->takeFocus() while holding a MenuContext::Use for it
+void MenuContext::start(MenuSystem *item)
 {
-    this->type = MENU_ITEM_TYPE::NONE;
-    if (!dispText || ! strlen(dispText))
-        dispText = (char *)naStr;
+    Use use(*this);
+    MenuLock lock(*this);
 
-    if (strlen(dispText) <= 14)
-        this->dispText =(char *) dispText;
-    else
+    if (item)
+        item->takeFocus();
+}
+
+// Send any display changes to the LCD (only the cells which have actually changed are written)
+// This is done for you by poll()
+void MenuContext::flush()
+{
+    MenuLock lock(*this);
+
+    sendFrame(0);
+}
+
+// Send up to byteBudget bus bytes (0 = no limit) of frame changes to the LCD - the custom characters
+// the frame needs first, as its characters mustn't go out before them - returning the number of
+// characters (and custom characters) sent
+int MenuContext::sendFrame(unsigned int byteBudget)
+{
+    MenuLock lock(*this);
+    MenuSystem *item = current();
+    unsigned int spent = 0;
+    int cells = 0;
+    int loaded;
+
+    if (!lcd || (item && item->kind() == MENU_ITEM_TYPE::FUNCTION))
+        return 0; // A MenuAction's function owns the LCD while the action has focus
+#if MENU_SYSTEM_STATS
+    unsigned long start = micros();
+    unsigned long busBytes = lcd->busBytes;
+#endif
+    loaded = sendGlyphs(byteBudget, spent);
+    if (!glyphs.pending())
+        cells = frame.flush(lcd, nullptr, byteBudget, spent);
+#if MENU_SYSTEM_STATS
+    unsigned long elapsed = micros() - start;
+    unsigned long bytes = lcd->busBytes - busBytes;
+
+    if (!cells && !loaded)
+        return 0;
+    // Each row's cost goes to the class which drew it (a MenuWatchValue in a Menu is counted as itself)
+    for (int row = 0; row < dispHeight; row++)
     {
-        // Try to AVOID using overly long strings as this will INCREASE RAM usage
-        // by creating multiple copies of the string in RAM.  These will NOT be freed
-        // until the menu system is destroyed (which is never in the current implementation).
-        // That's because menu objects need to be permanent (not constucted on the stack) so that
-        // they remain valid while the menu system is in use.
-        this->dispText = (char *)malloc(15 * sizeof(char));
-        memcpy(this->dispText, dispText, 14 * sizeof(char));
-        this->dispText[14] = 0;
+        MenuClassStats &classStats = stats.classes[frame.drawnBy[row]];
+
+        classStats.cellsWritten += frame.rowCells[row];
+        classStats.busBytes += frame.rowBytes[row];
     }
+    stats.flushes++;
+    if (byteBudget && !displayUpToDate())
+        stats.flushesCut++;
+    if (elapsed > stats.flushMicrosMax)
+        stats.flushMicrosMax = elapsed;
+    if (bytes > stats.flushBytesMax)
+        stats.flushBytesMax = bytes;
+#endif
+    return cells + loaded;
+}
+
+// Load the custom characters waiting to go to the LCD, within byteBudget bus bytes (0 = no limit),
+// adding what they cost to spent (see MenuGlyphCache::upload()).  Returns the number loaded.
+int MenuContext::sendGlyphs(unsigned int byteBudget, unsigned int &spent)
+{
+#if MENU_SYSTEM_STATS
+    unsigned long busBytes = lcd ? lcd->busBytes : 0;
+    int loaded = glyphs.upload(lcd, frame, byteBudget, spent);
+
+    if (loaded)
+        stats.glyphBytes += lcd->busBytes - busBytes;
+    return loaded;
+#else
+    return glyphs.upload(lcd, frame, byteBudget, spent);
+#endif
+}
+
+// False while some of the frame (or a custom character it needs) is still waiting to be sent
+bool MenuContext::displayUpToDate()
+{
+    MenuSystem *item = current();
+
+    return !lcd || (item && item->kind() == MENU_ITEM_TYPE::FUNCTION) || (!frame.dirty() && !glyphs.pending());
+}
+
+// Optional: send frame changes to the LCD from a task of our own, pinned to a core (e.g. the one your
+// stepper code isn't using), rather than from poll().  poll() still handles input (and so runs the
+// menu items' code & MenuAction functions) - other code which uses the menus must hold a MenuLock.
+// Returns false if the task couldn't be started (or MENU_SYSTEM_RENDER_TASK is 0).
+bool MenuContext::startRenderTask(int core, int priority, uint32_t stackSize)
+{
+    return renderTask.start(&MenuContext::renderFrom, this, mutex, core, priority, stackSize, 100);
+}
+
+// Returns once the task has gone (having sent anything still waiting) - poll() then updates the LCD itself again
+void MenuContext::stopRenderTask()
+{
+    renderTask.stop();
+}
+
+// The character to put on the display for a custom glyph (8 rows of 5 pixels, like createChar()), which
+// is loaded into one of the LCD's 8 custom character slots if it isn't there already.  Use this rather
+// than createChar(), so your glyphs & the menu system's don't overwrite each other.  Returns fallback if
+// every slot holds a glyph which is on the display.  It's loaded with the next frame (within the render
+// limits) - or straight away while a MenuAction has focus, as its function prints to the LCD itself.
+char MenuContext::glyph(const uint8_t bitmap[8], char fallback)
+{
+    MenuLock lock(*this);
+    MenuSystem *item = current();
+    int slot = glyphs.slotFor(bitmap, -1, frame, lcd);
+    unsigned int spent = 0;
+
+    if (slot < 0)
+        return fallback;
+    if (item && item->kind() == MENU_ITEM_TYPE::FUNCTION)
+        sendGlyphs(0, spent);
+    return MenuGlyphCache::code(slot);
+}
+
+// The character which displays one of the menu system's own symbols ('\001' return, '\002' enter,
+// '\003' rotary list, '\004' action) - any other c is returned as it is.  They're kept in slots 1-4
+// when they can be, as they always used to be.
+char MenuContext::symbol(char c)
+{
+    if (c < 1 || c > 4)
+        return c;
+    int slot = glyphs.slotFor(menuSymbols[c - 1], c, frame, lcd);
+
+    return slot < 0 ? ' ' : MenuGlyphCache::code(slot);
+}
+
+// Call this after writing directly to the LCD (for example, from a MenuAction function),
+// so the next flush() repaints the whole display rather than assuming it's unchanged
+void MenuContext::invalidateDisplay()
+{
+    MenuLock lock(*this);
+
+    frame.invalidate();
+}
+
+// The item which item returns focus to - the one below it on the stack (nullptr if it's at the
+// bottom, or doesn't have focus)
+MenuSystem *MenuContext::parentOf(const MenuSystem *item) const
+{
+    for (int i = focusDepth - 1; i > 0; i--)
+        if (focus[i] == item)
+            return focus[i - 1];
+    return nullptr;
+}
+
+// Called as item takes focus, putting it on top of the stack.  If it's on the stack already (a menu
+// retaking focus from its submenu, or the main menu taken again by a MenuAction) the items above it
+// are dropped instead, so the way back is always the way in.  Otherwise, the screen of the item it
+// covers is kept, so it can be put back when focus returns (see restoreScreen()).
+void MenuContext::push(MenuSystem *item)
+{
+    for (int i = 0; i < focusDepth; i++)
+        if (focus[i] == item)
+        {
+            focusDepth = i;
+            focus[focusDepth++] = item;
+            return;
+        }
+    if (focusDepth == MENU_SYSTEM_FOCUS_DEPTH)
+    {
+        // Deeper than we can remember - forget the bottom of the stack (and, as they've all moved, the screens)
+        memmove(focus, focus + 1, sizeof(focus) - sizeof(focus[0]));
+        focusDepth--;
+#if MENU_SYSTEM_SCREEN_CACHE_DEPTH
+        memset(screenSaved, 0, sizeof(screenSaved));
+#endif
+    }
+#if MENU_SYSTEM_SCREEN_CACHE_DEPTH
+    if (focusDepth > 0 && focusDepth <= MENU_SYSTEM_SCREEN_CACHE_DEPTH)
+    {
+        frame.save(screens[focusDepth - 1]);
+        screenSaved[focusDepth - 1] = true;
+    }
+    if (focusDepth < MENU_SYSTEM_SCREEN_CACHE_DEPTH)
+        screenSaved[focusDepth] = false;
+#endif
+    focus[focusDepth++] = item;
+}
+
+// Put item's screen back in the frame, as it was when the item above it took focus - for item (which
+// must have focus again) to redraw only what may have changed since.  False if it wasn't kept.
+bool MenuContext::restoreScreen(const MenuSystem *item)
+{
+#if MENU_SYSTEM_SCREEN_CACHE_DEPTH
+    int level = focusDepth - 1;
+
+    if (level < 0 || level >= MENU_SYSTEM_SCREEN_CACHE_DEPTH || focus[level] != item || !screenSaved[level])
+        return false;
+    frame.restore(screens[level]);
+    screenSaved[level] = false;
+    return true;
+#else
+    return false;
+#endif
+}
+
+// Write the redraw & latency statistics (see MENU_SYSTEM_STATS) to Serial (or another Print)
+void MenuContext::printStats(Print &out)
+{
+#if MENU_SYSTEM_STATS
+    char line[80];
+
+    out.println("Class                  displays    cells    bytes");
+    for (int i = 0; i < MENU_ITEM_TYPE_COUNT; i++)
+    {
+        MenuClassStats &c = stats.classes[i];
+        if (!c.displayCalls && !c.cellsWritten)
+            continue;
+        snprintf(line, sizeof(line), "%-22s %8lu %8lu %8lu", menuItemTypeNames[i], c.displayCalls, c.cellsWritten, c.busBytes);
+        out.println(line);
+    }
+    snprintf(line, sizeof(line), "Events %lu, latency us min/avg/max %lu/%lu/%lu", stats.events, stats.latencyMin,
+             stats.events ? (unsigned long)(stats.latencyTotal / stats.events) : 0, stats.latencyMax);
+    out.println(line);
+    snprintf(line, sizeof(line), "Flushes %lu (%lu cut short), worst flush %lu us/%lu bytes", stats.flushes, stats.flushesCut,
+             stats.flushMicrosMax, stats.flushBytesMax);
+    out.println(line);
+    snprintf(line, sizeof(line), "Screens restored on return %lu", stats.screensRestored);
+    out.println(line);
+    snprintf(line, sizeof(line), "Queue max depth %d, overflows %lu", events.maxDepth(), events.overflowCount());
+    out.println(line);
+    snprintf(line, sizeof(line), "Custom characters loaded %lu (%lu bytes), evicted %lu", glyphs.loads(), stats.glyphBytes, glyphs.evictions());
+    out.println(line);
+    snprintf(line, sizeof(line), "List entries fetched %lu (%lu redrawn from the cache)", lists.fetches(), lists.hits());
+    out.println(line);
+    snprintf(line, sizeof(line), "Settings commits %lu (%lu records, %lu sector erases)", MenuSystem::settings.commits(),
+             MenuSystem::settings.records(), MenuSystem::settings.erases());
+    out.println(line);
+#else
+    out.println("MenuSystem statistics are disabled (build with MENU_SYSTEM_STATS=1)");
+#endif
+}
+
+void MenuContext::resetStats()
+{
+#if MENU_SYSTEM_STATS
+    memset(&stats, 0, sizeof(stats));
+#endif
+    events.resetStats();
+    glyphs.resetStats();
+    lists.resetStats();
+    if (settingsContext == this)
+        MenuSystem::settings.resetStats();
+}
+
+// The item classes, for the footprint report
+#define MENU_ITEM_CLASSES(X)                                                                                         \
+    X(Menu) X(MenuDynamic) X(MenuAction) X(MenuBoolValue) X(MenuLongEditor) X(MenuLongValue) X(MenuFloatEditor)      \
+    X(MenuFloatValue) X(MenuFixedEditor) X(MenuFixedValue) X(MenuDropDownListValue) X(MenuRotaryListValue)          \
+    X(MenuWatchLong) X(MenuWatchText) X(MenuDashboard)
+
+// Each class's size, checked as the library builds: it has to fit the report's table and, if you've
+// set MENU_SYSTEM_MAX_ITEM_FOOTPRINT, that limit - so a change which makes an item bigger than you've
+// allowed for stops the build, naming the class, rather than turning up as a shortage of RAM
+#define MENU_FOOTPRINT_CHECK(T)                                                                  \
+    static_assert(sizeof(T) <= 0xFFFF, #T " is too big for the footprint report");               \
+    static_assert(!MENU_SYSTEM_MAX_ITEM_FOOTPRINT || sizeof(T) <= MENU_SYSTEM_MAX_ITEM_FOOTPRINT, \
+                  #T " takes more RAM than MENU_SYSTEM_MAX_ITEM_FOOTPRINT");
+MENU_ITEM_CLASSES(MENU_FOOTPRINT_CHECK)
+
+struct MenuClassFootprint
+{
+    const char *name;
+    uint16_t bytes;
+};
+
+#define MENU_FOOTPRINT_ENTRY(T) {#T, (uint16_t)sizeof(T)},
+static constexpr MenuClassFootprint menuClassFootprints[] = {MENU_ITEM_CLASSES(MENU_FOOTPRINT_ENTRY)};
+
+// A step on the way down a menu tree (see menuWalk())
+struct MenuTreePath
+{
+    const MenuSystem *item;
+    const MenuTreePath *up;
+};
+
+// Call visit(item) for item & everything it leads to, depth first, until visit returns false (false
+// if it did).  An entry leading back to a menu on the way down to it isn't followed, so a tree which
+// loops is still only walked once.
+template <class Visit>
+static bool menuWalk(const MenuSystem *item, const MenuTreePath *up, Visit &visit)
+{
+    MenuTreePath here = {item, up};
+    MenuSystem *const *children;
+    int count;
+
+    for (const MenuTreePath *step = up; step; step = step->up)
+        if (step->item == item)
+            return true;
+    if (!visit(item))
+        return false;
+    children = item->children(count);
+    for (int i = 0; i < count; i++)
+        if (children[i] && !menuWalk(children[i], &here, visit))
+            return false;
+    return true;
+}
+
+// The items of a tree, by type.  Each is counted once, however many menus it's in - where the walk
+// first comes to it, which is found by walking again from the root, rather than keeping a list of the
+// items counted so far (slow for a big tree, but the report needs no memory beyond these totals).
+struct MenuFootprintTally
+{
+    const MenuSystem *root;
+    int reached = 0; // Items the walk has come to so far (shared ones each time)
+    int count = 0;
+    int items[MENU_ITEM_TYPE_COUNT] = {};
+    size_t bytes[MENU_ITEM_TYPE_COUNT] = {};
+
+    MenuFootprintTally(const MenuSystem *root) : root(root) {}
+
+    bool operator()(const MenuSystem *item)
+    {
+        int position = reached++;
+        int first = 0;
+        auto find = [&](const MenuSystem *other) -> bool
+        {
+            if (other == item)
+                return false;
+            first++;
+            return true;
+        };
+
+        menuWalk(root, nullptr, find);
+        if (first == position)
+        {
+            items[item->kind()]++;
+            bytes[item->kind()] += item->footprint();
+            count++;
+        }
+        return true;
+    }
+};
+
+// Write the RAM each class of menu item takes, what this context & the saved settings take and, if
+// root is given, what the items of its tree (root & everything it leads to) take altogether
+void MenuContext::printFootprint(const MenuSystem *root, Print &out)
+{
+    char line[80];
+
+    out.println("Item class             bytes");
+    for (auto &footprint : menuClassFootprints)
+    {
+        snprintf(line, sizeof(line), "%-22s %5u", footprint.name, footprint.bytes);
+        out.println(line);
+    }
+    snprintf(line, sizeof(line), "MenuContext %u bytes, settings %u bytes (shared)", (unsigned)sizeof(MenuContext), (unsigned)sizeof(MenuSettings));
+    out.println(line);
+    if (!root)
+        return;
+
+    MenuFootprintTally totals(root);
+    size_t total = 0;
+
+    menuWalk(root, nullptr, totals);
+    for (int i = 0; i < MENU_ITEM_TYPE_COUNT; i++)
+    {
+        if (!totals.items[i])
+            continue;
+        snprintf(line, sizeof(line), "%-22s %5d items %7u bytes", menuItemTypeNames[i], totals.items[i], (unsigned)totals.bytes[i]);
+        out.println(line);
+        total += totals.bytes[i];
+    }
+    snprintf(line, sizeof(line), "Menu items %d, %u bytes (menus & items only)", totals.count, (unsigned)total);
+    out.println(line);
+}
+
+// The MenuSystem statics act on the context in use - the default one (MenuContext::primary), unless
+// they're called from another context's callbacks (or under a MenuContext::Use)
+void MenuSystem::begin(int displayWidth, int displayHeight, LiquidCrystal_I2C *display, RotaryEncoder *Aencoder, RotaryEncoder *Bencoder)
+{
+    context().begin(displayWidth, displayHeight, display, Aencoder, Bencoder);
+}
+
+void MenuSystem::begin(int displayWidth, int displayHeight, MenuDisplayTransport *display, RotaryEncoder *Aencoder, RotaryEncoder *Bencoder)
+{
+    context().begin(displayWidth, displayHeight, display, Aencoder, Bencoder);
+}
+
+void MenuSystem::poll()
+{
+    context().poll();
+}
+
+void MenuSystem::flush()
+{
+    context().flush();
+}
+
+void MenuSystem::setRenderLimits(unsigned int maxFramesPerSecond, unsigned int frameByteBudget)
+{
+    context().setRenderLimits(maxFramesPerSecond, frameByteBudget);
+}
+
+bool MenuSystem::startRenderTask(int core, int priority, uint32_t stackSize)
+{
+    return context().startRenderTask(core, priority, stackSize);
+}
+
+void MenuSystem::stopRenderTask()
+{
+    context().stopRenderTask();
+}
+
+char MenuSystem::glyph(const uint8_t bitmap[8], char fallback)
+{
+    return context().glyph(bitmap, fallback);
+}
+
+void MenuSystem::invalidateDisplay()
+{
+    context().invalidateDisplay();
+}
+
+int MenuSystem::queueDepth()
+{
+    return context().events.depth();
+}
+
+int MenuSystem::queueMaxDepth()
+{
+    return context().events.maxDepth();
+}
+
+unsigned long MenuSystem::queueOverflows()
+{
+    return context().events.overflowCount();
+}
+
+void MenuSystem::resetQueueStats()
+{
+    context().events.resetStats();
+}
+
+void MenuSystem::printStats(Print &out)
+{
+    context().printStats(out);
+}
+
+void MenuSystem::resetStats()
+{
+    context().resetStats();
+}
+
+void MenuSystem::printFootprint(const MenuSystem *root, Print &out)
+{
+    context().printFootprint(root, out);
+}
+
+// Restore the values of the persisted items (see persist() on the value items) from storage, then
+// keep it up to date: a changed value is written once its editor returns focus, or after
+// commitDelay ms if it's still being edited (or was changed by the sketch).  Call this after the
+// persist() calls & before anything reads the values.  Returns false if storage can't be used.
+// The settings are shared by all the contexts; the one in use here writes them from its poll().
+bool MenuSystem::beginSettings(MenuStorage *storage, uint32_t commitDelay)
+{
+    MenuLock lock;
+
+    MenuContext::settingsContext = &context();
+    return settings.begin(storage, commitDelay);
+}
+
+// Write any changed values now (e.g. before a deliberate power down)
+bool MenuSystem::saveSettings()
+{
+    MenuLock lock(MenuContext::settingsContext ? *MenuContext::settingsContext : context());
+
+    return settings.commit();
+}
+
+// Strings are never copied - anything too long for the display is clipped when it's drawn
+MenuTextView MenuTextView::of(const char *text, const char *fallback)
+{
+    if (!text || !*text)
+        text = fallback;
+    return MenuTextView(text, (uint8_t)min(strlen(text), (size_t)255));
+}
+
+MenuSystem::MenuSystem(const char *dispText)
+{
+    MenuTextView label = MenuTextView::of(dispText, naStr);
+
+    this->dispText = label.text;
+    this->dispLength = label.length;
 }
 
 void MenuSystem::display(int row, bool select)
 {
-    char outputText[17];
-    sprintf(outputText, "%c%-14s%c", select ? '>' : ' ', dispText, select ? typeIndicator : ' ');
-    lcd->setCursor(0, row);
-    lcd->print(outputText);
+    MenuContext &ctx = context();
+
+    ctx.frame.row(row).put(select ? '>' : ' ').field(dispText, dispLength, ctx.dispWidth - 2).put(select ? ctx.symbol(typeIndicator) : ' ');
 }
 
 void MenuSystem::displayValue()
@@ -139,193 +775,314 @@ void MenuSystem::displayValue()
 
 void MenuSystem::takeFocus()
 {
-    prevMenu = currentMenu;
-    currentMenu = this;
+    MenuContext &ctx = context();
 
-    lcd->clear();
-    lcd->setCursor(0, 0);
-    lcd->print(dispText);
+    ctx.push(this);
+
+    // The new screen is built as a whole frame, and only its differences from the old one are sent
+    // (no clear() - it blocks the bus for 2ms and makes the display flash)
+    MENU_STAT(ctx.frame.pen = kind());
+    ctx.frame.clear();
+    ctx.frame.print(0, 0, dispText, min((int)dispLength, ctx.dispWidth - 2));
     displayValue();
 }
 
+// Focus goes back to the item below this one on the context's focus stack - wherever this item
+// was opened from (an item can be in several menus)
 void MenuSystem::returnFocus(ENCODER_SOURCE source, ENCODER_EVENT event, unsigned long value)
 {
-    if (prevMenu == nullptr)
+    MenuSystem *previous = parent();
+
+    if (previous == nullptr)
         return; // No previous menu to return to
-    prevMenu->retakeFocus(this, source, event, value);
+    previous->retakeFocus(this, source, event, value);
 }
 
 void MenuSystem::retakeFocus(MenuSystem *returningMenu, ENCODER_SOURCE source, ENCODER_EVENT event, unsigned long value)
 {
-    currentMenu = this;
+    context().push(this);
     displayValue();
 }
 
+// Handle several detents of the same encoder at once (delta is +ve for clockwise).
+// By default, each detent is passed to inputHandler() in turn; classes which can apply
+// the whole delta in one go override this.
+void MenuSystem::turnHandler(ENCODER_SOURCE source, long delta)
+{
+    while (delta)
+    {
+        inputHandler(source, ENCODER_EVENT::TURNED, delta > 0 ? 1 : 0);
+        delta += delta > 0 ? -1 : 1;
+        if (context().current() != this)
+        {
+            // Focus has moved on (e.g. a MenuRotaryListValue returned to its Menu), so
+            // the rest of the turn belongs to whoever has focus now
+            context().dispatchTurn(source, delta, context().turnTime);
+            return;
+        }
+    }
+}
+
 Menu::Menu(const char *dispText, MenuSystem **menuItems) : MenuSystem(dispText)
 {
     this->menuItems = menuItems;
     for (itemCount = 0; this->menuItems[itemCount] != nullptr; itemCount++)
         ;
-    this->type = MENU_ITEM_TYPE::MENU;
     typeIndicator = '\002'; // Down arrow indicates submenu
 }
 
+// Entries are numbered from -1 (the title, or the "return to previous menu" entry) to itemCount - 1.
+// The display is a viewport onto them, starting at topIndex, which only scrolls when the
+// selection would otherwise leave it (so the selection marker stays put where it can).
 void Menu::displayValue()
 {
-    char outputText[17];
-    int startIndex, maxIndex, i, row = 0;
+    MenuContext &ctx = context();
 
-    if (!prevMenu && selectedIndex == -1)
+    MENU_STAT(ctx.drawing(kind()));
+    if (!parent() && selectedIndex == -1)
         selectedIndex = 0; // No previous menu, so can't return, start at first item
-    switch (selectedIndex)
-    {
-    case -1:
-        startIndex = 0;
-        maxIndex = 0;
-        if (prevMenu)
-            sprintf(outputText, "%c%-14s\001", selectionChar, prevMenu->dispText);
-        else
-            sprintf(outputText, "%-16s", dispText);
-        lcd->setCursor(0, row++);
-        lcd->print(outputText);
-        break;
-    case 0:
-        startIndex = 0;
-        maxIndex = 0;
-        if (prevMenu)
-            sprintf(outputText, " %-15s", prevMenu->dispText);
+    scrollToSelection();
+    for (int row = 0; row < ctx.dispHeight; row++)
+        displayEntry(topIndex + row, row);
+}
+
+void Menu::displayEntry(int index, int row)
+{
+    MenuContext &ctx = context();
+    MenuSystem *previous = ctx.parentOf(this);
+    bool select = index == selectedIndex;
+
+    MENU_STAT(ctx.frame.pen = kind()); // (Entries which draw their own value, e.g. a MenuWatchValue, count it as theirs)
+    if (index >= itemCount)
+        ctx.frame.row(row).padTo(ctx.dispWidth); // Blank (short menu on a tall display)
+    else if (index >= 0)
+        if (MenuSystem *entry = item(index))
+            entry->display(row, select);
         else
-            sprintf(outputText, "%-16s", dispText);
-        lcd->setCursor(0, row++);
-        lcd->print(outputText);
-        break;
-    default:
-        startIndex = selectedIndex - 1;
-        maxIndex = selectedIndex;
-        break;
-    }
-    for (i = startIndex; i <= maxIndex; i++)
-        menuItems[i]->display(row++, i == selectedIndex);
+            ctx.frame.row(row).padTo(ctx.dispWidth);
+    else if (previous)
+        ctx.frame.row(row).put(select ? selectionChar : ' ').field(previous->dispText, previous->dispLength, ctx.dispWidth - 2).put(select ? ctx.symbol('\001') : ' ');
+    else
+        ctx.frame.row(row).field(dispText, min((int)dispLength, ctx.dispWidth - 2), ctx.dispWidth);
+}
+
+// Returns true if the viewport moved
+bool Menu::scrollToSelection()
+{
+    MenuContext &ctx = context();
+    int top = topIndex;
+
+    if (selectedIndex <= 0)
+        top = -1; // Keep the title/return entry in view along with the first item
+    else if (selectedIndex < top)
+        top = selectedIndex;
+    else if (selectedIndex >= top + ctx.dispHeight)
+        top = selectedIndex - ctx.dispHeight + 1;
+    top = min(top, max(-1, itemCount - ctx.dispHeight)); // Don't leave blank rows at the bottom if we can help it
+    if (top == topIndex)
+        return false;
+    topIndex = top;
+    return true;
 }
 
 void Menu::takeFocus()
 {
-    prevMenu = currentMenu;
-    currentMenu = this;
-    selectedIndex = 0;
-    lcd->clear();
-    lcd->setCursor(0, 0);
+    MenuContext &ctx = context();
+
+    ctx.push(this);
+    // Open where it was left (and scrolled to), unless that was its return entry - or there's nothing
+    // else to select (e.g. a MenuDynamic with no entries), when only the return entry can be
+    if (selectedIndex < 0 || selectedIndex >= itemCount)
+        selectedIndex = itemCount > 0 || !parent() ? 0 : -1;
+    MENU_STAT(ctx.frame.pen = kind());
+    ctx.frame.clear(); // Redrawn in full, but only the differences reach the LCD (see MenuSystem::takeFocus())
     displayValue();
 }
 
+// Back from an entry: if the screen was kept as it was left (see MenuContext::restoreScreen()), only the
+// returning entry's row and those showing a value (which may have changed meanwhile) are drawn again
 void Menu::retakeFocus(MenuSystem *returningMenu, ENCODER_SOURCE source, ENCODER_EVENT event, unsigned long value)
 {
-    MenuSystem::retakeFocus(returningMenu, source, event, value);
+    MenuContext &ctx = context();
+
+    ctx.push(this);
+    MENU_STAT(ctx.frame.pen = kind());
+    if (ctx.restoreScreen(this) && kind() == MENU_ITEM_TYPE::MENU && !scrollToSelection())
+    {
+        MENU_STAT(ctx.stats.screensRestored++);
+        MENU_STAT(ctx.drawing(kind()));
+        for (int row = 0; row < ctx.dispHeight; row++)
+        {
+            int index = topIndex + row;
+
+            if (index == selectedIndex || (index >= 0 && index < itemCount && showsValue(item(index))))
+                displayEntry(index, row);
+        }
+    }
+    else
+        displayValue(); // (A MenuDynamic's entries are built afresh, as they may have changed)
     if (event == ENCODER_EVENT::TURNED)
         inputHandler(source, event, value); // Pass on the turn event to change selection
 }
 
+// Redraw any live values (MenuWatchValue items) on the display which have changed
+void Menu::refresh()
+{
+    for (int row = 0; row < context().dispHeight; row++)
+    {
+        int index = topIndex + row;
+
+        if (index >= 0 && index < itemCount && watchChanged(item(index)))
+            displayEntry(index, row);
+    }
+}
+
 void Menu::inputHandler(ENCODER_SOURCE source, ENCODER_EVENT event, unsigned long value)
 {
     if (event == ENCODER_EVENT::PRESSED)
     {
         // Select submenu
         if (selectedIndex >= 0 && selectedIndex < itemCount)
-            menuItems[selectedIndex]->takeFocus();
+        {
+            if (MenuSystem *entry = item(selectedIndex))
+                entry->takeFocus();
+        }
         else if (selectedIndex == -1)
             returnFocus(source, event, value);
     }
     else if (event == ENCODER_EVENT::TURNED)
+        turnHandler(source, value == 1 ? 1 : -1);
+}
+
+void Menu::turnHandler(ENCODER_SOURCE source, long delta)
+{
+    // Change selected index - between the return entry (if there is one) and the last item, so an
+    // empty menu keeps its return entry selected
+    int first = parent() ? -1 : 0;
+    int previousIndex = selectedIndex;
+
+    if (itemCount - 1 < first)
+        return; // Nothing to select
+    selectedIndex += delta;
+    if (selectedIndex < first)
+        selectedIndex = first;
+    if (selectedIndex >= itemCount)
+        selectedIndex = itemCount - 1;
+    // Display menu with new selection - if the viewport hasn't moved, only the rows
+    // losing and gaining the selection marker need redrawing
+    if (scrollToSelection())
+        displayValue();
+    else if (selectedIndex != previousIndex)
     {
-        // Change selected index
-        if (menuItems && itemCount > 0)
-        {
-            selectedIndex += value == 1 ? 1 : -1;
-            if (prevMenu)
-            {
-                if (selectedIndex < -1)
-                    selectedIndex = -1;
-            }
-            else
-            {
-                if (selectedIndex < 0)
-                    selectedIndex = 0;
-            }
-            if (selectedIndex >= itemCount)
-                selectedIndex = itemCount - 1;
-            // Display menu with new selection
-            displayValue();
-        }
+        MENU_STAT(context().drawing(kind()));
+        displayEntry(previousIndex, previousIndex - topIndex);
+        displayEntry(selectedIndex, selectedIndex - topIndex);
     }
 }
 
-MenuBoolValue::MenuBoolValue(const char *dispText, const char *trueOption, const char *falseOption, bool *value) : MenuSystem(dispText)
+MenuDynamic::MenuDynamic(const char *dispText, MenuItemGenerator *generator) : Menu(dispText)
 {
-    if (!falseOption || !strlen(falseOption))
-        falseOption = (char *)naStr;
-    if (!trueOption || !strlen(trueOption))
-        trueOption = (char *)naStr;
+    this->generator = generator;
+    typeIndicator = '\002';
+}
 
-        if (strlen(trueOption) <= 7)
-        this->trueOption =(char *) trueOption;
-    else
+// The item for entry index - built (in place of an entry which is no longer on the display) if need be
+MenuSystem *MenuDynamic::item(int index)
+{
+    MenuItemSlot *slot = nullptr;
+
+    for (MenuItemSlot &candidate : slots)
     {
-        // Try to AVOID using overly long strings as this will INCREASE RAM usage
-        // by creating multiple copies of the string in RAM.  These will NOT be freed
-        // until the menu system is destroyed (which is never in the current implementation).
-        // That's because menu objects need to be permanent (not constucted on the stack) so that
-        // they remain valid while the menu system is in use.
-        this->trueOption = (char *)malloc(8 * sizeof(char));
-        memcpy(this->trueOption, trueOption, 7 * sizeof(char));
-        this->trueOption[7] = 0;
+        if (candidate.index == index)
+            return candidate.item;
+        if (!slot && (candidate.index < max(topIndex, 0) || candidate.index >= topIndex + context().dispHeight) && candidate.index != selectedIndex)
+            slot = &candidate;
     }
+    if (!slot || !generator)
+        return nullptr;
+    slot->index = index;
+    slot->item = nullptr;
+    slot->label[0] = 0;
+    if (generator->build(index, *slot) != slot->item)
+        slot->item = nullptr; // (Not built with make())
+    return slot->item;
+}
 
-    if (strlen(falseOption) <= 7)
-        this->falseOption =(char *) falseOption;
-    else
+void MenuDynamic::release()
+{
+    for (MenuItemSlot &slot : slots)
     {
-        // Try to AVOID using overly long strings as this will INCREASE RAM usage
-        // by creating multiple copies of the string in RAM.  These will NOT be freed
-        // until the menu system is destroyed (which is never in the current implementation).
-        // That's because menu objects need to be permanent (not constucted on the stack) so that
-        // they remain valid while the menu system is in use.
-        this->falseOption = (char *)malloc(8 * sizeof(char));
-        memcpy(this->falseOption, falseOption, 7 * sizeof(char));
-        this->falseOption[7] = 0;
+        slot.index = -1;
+        slot.item = nullptr;
     }
+}
 
+void MenuDynamic::takeFocus()
+{
+    release();
+    itemCount = generator ? max(generator->count(), 0) : 0;
+    Menu::takeFocus();
+}
+
+void MenuDynamic::returnFocus(ENCODER_SOURCE source, ENCODER_EVENT event, unsigned long value)
+{
+    if (parent() == nullptr)
+        return;
+    release();
+    MenuSystem::returnFocus(source, event, value);
+}
+
+// Call this when the generator's entries have changed, while the menu has focus, to rebuild them
+void MenuDynamic::itemsChanged()
+{
+    for (int i = 0; MenuContext *ctx = MenuContext::begun(i); i++)
+    {
+        MenuContext::Use use(*ctx);
+        MenuLock lock(*ctx);
+
+        if (ctx->current() != this)
+            continue; // (They're built afresh when it next takes focus)
+        release();
+        itemCount = generator ? max(generator->count(), 0) : 0;
+        selectedIndex = min(selectedIndex, itemCount - 1);
+        displayValue();
+    }
+}
+
+MenuBoolValue::MenuBoolValue(const char *dispText, const char *trueOption, const char *falseOption, bool *value) : MenuSystem(dispText)
+{
+    this->trueOption = MenuTextView::of(trueOption, naStr);
+    this->falseOption = MenuTextView::of(falseOption, naStr);
     this->value = value;
-    this->type = MENU_ITEM_TYPE::BOOL_VALUE;
 }
 
 void MenuBoolValue::displayValue()
 {
-    char fmt[17];
-    char trueText[17];
-    char falseText[17];
-    char outputText[17];
-    int lenTrueText;;
+    MenuContext &ctx = context();
+    int optionWidth = (ctx.dispWidth - 2) / 2; // Two options (and their markers) share a row
+    int falseLength = min((int)falseOption.length, optionWidth);
 
-    if (lcd && value)
+    MENU_STAT(ctx.drawing(kind()));
+    if (ctx.lcd && value)
     {
-        lcd->setCursor(15, 0);
-        lcd->print("\001"); // 1 is the return symbol
-        // Display options with current value indicated by '>'
-        sprintf(trueText, "%c%s", *value == true ? '>' : ' ', trueOption);
-        sprintf(falseText, "%c%s", *value == false ? '>' : ' ', falseOption);
-        lenTrueText = strlen(trueText);
-        sprintf(fmt, "%s%%%ds", trueText, 16 - lenTrueText);
-        sprintf(outputText, fmt, falseText);
-        lcd->setCursor(0, 1);
-        lcd->print(outputText);
+        ctx.frame.put(ctx.dispWidth - 1, 0, ctx.symbol('\001')); // 1 is the return symbol
+        // Display options with current value indicated by '>' (true option on the left, false option right-aligned)
+        ctx.frame.row(1)
+            .put(*value == true ? '>' : ' ')
+            .text(trueOption.text, min((int)trueOption.length, optionWidth))
+            .padTo(ctx.dispWidth - 1 - falseLength)
+            .put(*value == false ? '>' : ' ')
+            .text(falseOption.text, falseLength);
     }
 }
 
 void MenuBoolValue::takeFocus()
 {
+    MenuContext &ctx = context();
+
     MenuSystem::takeFocus();
-    lcd->setCursor(15, 0);
-    lcd->print("\001"); // 1 is the return symbol
+    notify.editing(ctx.changes, this, value, sizeof(*value));
+    ctx.frame.put(ctx.dispWidth - 1, 0, ctx.symbol('\001')); // 1 is the return symbol
 }
 
 void MenuBoolValue::inputHandler(ENCODER_SOURCE source, ENCODER_EVENT event, unsigned long value)
@@ -333,175 +1090,212 @@ void MenuBoolValue::inputHandler(ENCODER_SOURCE source, ENCODER_EVENT event, uns
     if (event == ENCODER_EVENT::PRESSED)
     {
         // Exit & return control to parent
+        notify.commit(context().changes);
         returnFocus(source, event, value);
     }
     else if (event == ENCODER_EVENT::TURNED)
-    {
-        // Change value
+        turnHandler(source, value == 1 ? 1 : -1);
+}
+
+void MenuBoolValue::turnHandler(ENCODER_SOURCE source, long delta)
+{
+    // Each detent toggles the value, so only an odd number of detents changes it
+    if (delta % 2)
         *(this->value) = *(this->value) ? false : true;
-        displayValue();
-    }
+    notify.update(context().changes);
+    displayValue();
+}
+
+MenuLongValue::MenuLongValue(const char *dispText, const char *units, long minValue, long maxValue, long coarseStep, long fineStep, long *value)
+    : MenuLongEditor(dispText, own, value), own(MenuTextView::of(units), minValue, maxValue, coarseStep, fineStep)
+{
 }
 
-MenuLongValue::MenuLongValue(const char *dispText, const char *units, long minValue, long maxValue, long coarseStep, long fineStep, long *value) : MenuSystem(dispText)
+MenuFloatValue::MenuFloatValue(const char *dispText, const char *units, float minValue, float maxValue, float coarseStep, float fineStep, float *value)
+    : MenuFloatEditor(dispText, own, value), own(MenuTextView::of(units), minValue, maxValue, coarseStep, fineStep)
 {
-    this->minValue = min(minValue, maxValue);
-    this->maxValue = max(minValue, maxValue);
-    this->coarseStep = coarseStep > 0 ? coarseStep : 100;
-    this->fineStep = fineStep > 0 ? fineStep : 1;
+}
 
-    if (units)
-        this->units = (char *)units;
-    else
-        this->units = (char *)"";
-    this->value = value;
-    this->type = MENU_ITEM_TYPE::LONG_VALUE;
+MenuFixedValue::MenuFixedValue(const char *dispText, const char *units, uint8_t decimals, long minValue, long maxValue, long coarseStep, long fineStep, long *value)
+    : MenuFixedEditor(dispText, own, value), own(MenuTextView::of(units), decimals, minValue, maxValue, coarseStep, fineStep)
+{
 }
 
-void MenuLongValue::displayValue()
+// How each kind of MenuNumberEditor shows its value
+static void menuFormatNumber(MenuFormatter &out, long value, const MenuLongSpec &spec)
 {
-    char valStr[17];
-    char outputText[17];
-    if (lcd && value)
-    {
-        sprintf(valStr, "%ld %s", *value, units ? units : "");
-        sprintf(outputText, "%-15s\001", valStr); // 1 is the return symbol
-        lcd->setCursor(0, 1);
-        lcd->print(outputText);
-    }
+    out.number(value);
 }
 
-void MenuLongValue::inputHandler(ENCODER_SOURCE source, ENCODER_EVENT event, unsigned long value)
+// Shown to 3 decimal places, without using (the large, slow) float printf.  A value too big for a long
+// of thousandths (which an editor without limits can reach) is shown in powers of ten, e.g. "-2.147e9",
+// rather than converted - that would be undefined.
+static void menuFormatNumber(MenuFormatter &out, float value, const MenuFloatSpec &spec)
 {
-    if (event == ENCODER_EVENT::PRESSED)
+    long scaled;
+    int exponent = 0;
+
+    if (isnan(value))
     {
-        // Exit menu
-        returnFocus(source, event, value);
+        out.text("nan");
+        return;
     }
-    else if (event == ENCODER_EVENT::TURNED)
+    if (fabsf(value) < LONG_MAX / 1000)
     {
-        // Change value
-        if (this->value)
-        {
-            if (source == ENCODER_SOURCE::A)
-            {
-                *(this->value) += value == 1 ? coarseStep : 0 - coarseStep;
-            }
-            else
-            {
-                *(this->value) += value == 1 ? fineStep : 0 - fineStep;
-            }
-            if (minValue != maxValue)
-            {
-                if (*(this->value) > maxValue)
-                    *(this->value) = maxValue;
-                else if (*(this->value) < minValue)
-                    *(this->value) = minValue;
-            }
-            displayValue();
-        }
+        out.fixed((long)(value * 1000.0f + (value < 0 ? -0.5f : 0.5f)), 3);
+        return;
     }
+    if (value < 0)
+    {
+        out.put('-');
+        value = -value;
+    }
+    if (isinf(value))
+    {
+        out.text("inf");
+        return;
+    }
+    for (; value >= 10.0f; exponent++)
+        value /= 10.0f;
+    scaled = (long)(value * 1000.0f + 0.5f);
+    if (scaled >= 10000) // (9.9995 rounds up to 10.000)
+    {
+        scaled /= 10;
+        exponent++;
+    }
+    out.fixed(scaled, 3).put('e').number(exponent);
 }
 
-MenuFloatValue::MenuFloatValue(const char *dispText, const char *units, float minValue, float maxValue, float coarseStep, float fineStep, float *value) : MenuSystem(dispText)
+static void menuFormatNumber(MenuFormatter &out, long value, const MenuFixedSpec &spec)
 {
-    this->minValue = min(minValue, maxValue);
-    this->maxValue = max(minValue, maxValue);
-    this->coarseStep = coarseStep > 0 ? coarseStep : 0.1;
-    this->fineStep = fineStep > 0 ? fineStep : 0.001;
-    this->units = (char *)units;
-    this->value = value;
-    this->type = MENU_ITEM_TYPE::SMALL_FLOAT_VALUE;
+    out.fixed(value, spec.decimals);
 }
 
-void MenuFloatValue::displayValue()
+template <class T, class Spec>
+void MenuNumberEditor<T, Spec>::displayValue()
 {
-    char valStr[17];
-    char outputText[17];
-    sprintf(valStr, "%0.3f %s", *value, units ? units : "");
-    sprintf(outputText, "%-14s \001", valStr); // 1 is the return symbol
-    lcd->setCursor(0, 1);
-    lcd->print(outputText);
+    MenuContext &ctx = context();
+
+    MENU_STAT(ctx.drawing(kind()));
+    if (ctx.lcd && value)
+    {
+        MenuFormatter out = ctx.frame.row(1);
+
+        menuFormatNumber(out, *value, *spec);
+        out.units(spec->units).padTo(ctx.dispWidth - 1).at(ctx.dispWidth - 1).put(ctx.symbol('\001')); // 1 is the return symbol
+    }
 }
 
-void MenuFloatValue::inputHandler(ENCODER_SOURCE source, ENCODER_EVENT event, unsigned long value)
+template <class T, class Spec>
+void MenuNumberEditor<T, Spec>::inputHandler(ENCODER_SOURCE source, ENCODER_EVENT event, unsigned long value)
 {
     if (event == ENCODER_EVENT::PRESSED)
     {
         // Exit menu
+        notify.commit(context().changes);
         returnFocus(source, event, value);
     }
     else if (event == ENCODER_EVENT::TURNED)
+        turnHandler(source, value == 1 ? 1 : -1);
+}
+
+template <class T, class Spec>
+void MenuNumberEditor<T, Spec>::turnHandler(ENCODER_SOURCE source, long delta)
+{
+    MenuContext &ctx = context();
+
+    // Change value (for the integer kinds, exactly - repeated steps never drift)
+    if (this->value)
     {
-        // Change value
-        if (this->value)
+        delta = ctx.accelerator.apply(acceleration, this, source, delta, ctx.turnTime);
+        *(this->value) += delta * (source == ENCODER_SOURCE::A ? spec->coarseStep : spec->fineStep);
+        if (spec->minValue != spec->maxValue)
         {
-            if (source == ENCODER_SOURCE::A)
-            {
-                *(this->value) += value == 1 ? 0.05 : -0.05;
-            }
-            else
-            {
-                *(this->value) += value == 1 ? 0.001 : -0.001;
-            }
-            if (minValue != maxValue)
-            {
-                if (*(this->value) > maxValue)
-                    *(this->value) = maxValue;
-                else if (*(this->value) < minValue)
-                    *(this->value) = minValue;
-            }
-            displayValue();
+            if (*(this->value) > spec->maxValue)
+                *(this->value) = spec->maxValue;
+            else if (*(this->value) < spec->minValue)
+                *(this->value) = spec->minValue;
         }
+        notify.update(ctx.changes);
+        displayValue();
     }
 }
 
+template <class T, class Spec>
+void MenuNumberEditor<T, Spec>::takeFocus()
+{
+    MenuSystem::takeFocus();
+    notify.editing(context().changes, this, value, sizeof(*value));
+}
+
+// Pass nullptr to turn acceleration off again
+template <class T, class Spec>
+void MenuNumberEditor<T, Spec>::setAcceleration(const MenuAccelerationProfile *profile)
+{
+    acceleration = profile;
+}
+
+// A stored value may be from before the limits were changed
+template <class T, class Spec>
+void MenuNumberEditor<T, Spec>::restored()
+{
+    if (spec->minValue != spec->maxValue) // Equal limits mean no limits (as in turnHandler())
+        *value = constrain(*value, spec->minValue, spec->maxValue);
+}
+
+template class MenuNumberEditor<long, MenuLongSpec>;
+template class MenuNumberEditor<float, MenuFloatSpec>;
+template class MenuNumberEditor<long, MenuFixedSpec>;
+
+void MenuFixedEditor::turnHandler(ENCODER_SOURCE source, long delta)
+{
+    MenuNumberEditor::turnHandler(source, delta);
+    if (published && value)
+        *published = (int32_t)*value;
+}
+
+void MenuFixedEditor::restored()
+{
+    MenuNumberEditor::restored();
+    if (published)
+        *published = (int32_t)*value;
+}
+
+// Keep an int32 copy of the (scaled) value up to date for code which shouldn't have to
+// know about longs (e.g. stepper maths) - written immediately, then after every change
+void MenuFixedEditor::publishTo(volatile int32_t *target)
+{
+    published = target;
+    if (published && value)
+        *published = (int32_t)*value;
+}
+
 MenuDropDownListValue::MenuDropDownListValue(const char *dispText, const char **listItems, int *value) : MenuSystem(dispText)
 {
-    this->listItems = (char **)listItems;
+    int itemCount;
+
     for (itemCount = 0; listItems[itemCount] != nullptr; itemCount++)
         ;
+    this->list = MenuListSource(listItems, itemCount);
     this->value = value;
-    this->type = MENU_ITEM_TYPE::DROP_DOWN_LIST_VALUE;
-
-    char temp[15];
-    for (int i = 0; i < itemCount; i++)
-    {
-        if (strlen(this->listItems[i]) > 14)
-        {
-            // Try to AVOID using overly long strings as this will INCREASE RAM usage
-            // by creating multiple copies of the string in RAM.  These will NOT be freed
-            // until the menu system is destroyed (which is never in the current implementation).
-            // That's because menu objects need to be permanent (not constucted on the stack) so that
-            // they remain valid while the menu system is in use.
-            memcpy(temp, listItems[i], 14 * sizeof(char));
-            temp[14] = 0;                                      // Truncate to 14 characters
-            this->listItems[i] = (char *)malloc(15 * sizeof(char)); // Allocate 15 bytes (14 chars + null terminator)
-            memcpy(this->listItems[i], temp, 15 * sizeof(char));
-        }
-        else
-            this->listItems[i] = (char *)listItems[i];
-    }
 }
 
 void MenuDropDownListValue::displayValue()
 {
-    char outputText[17];
-    int index = *value;
-    if (index < 0)
-        index = 0;
-    if (index >= itemCount)
-        index = itemCount - 1;
-    sprintf(outputText, "%c%-15s", selectionChar, listItems[index]);
-    lcd->setCursor(0, 1);
-    lcd->print(outputText);
+    MenuContext &ctx = context();
+    int index = constrain(*value, 0, list.count() - 1);
+
+    MENU_STAT(ctx.drawing(kind()));
+    ctx.frame.row(1).put(selectionChar).field(ctx.lists.text(this, list, index), -1, ctx.dispWidth - 1);
 }
 
 void MenuDropDownListValue::takeFocus()
 {
+    MenuContext &ctx = context();
+
     MenuSystem::takeFocus();
-    lcd->setCursor(15, 0);
-    lcd->print("\001"); // 1 is the return symbol
+    notify.editing(ctx.changes, this, value, sizeof(*value));
+    ctx.frame.put(ctx.dispWidth - 1, 0, ctx.symbol('\001')); // 1 is the return symbol
 }
 
 void MenuDropDownListValue::inputHandler(ENCODER_SOURCE source, ENCODER_EVENT event, unsigned long value)
@@ -509,49 +1303,59 @@ void MenuDropDownListValue::inputHandler(ENCODER_SOURCE source, ENCODER_EVENT ev
     if (event == ENCODER_EVENT::PRESSED)
     {
         // Exit menu
+        notify.commit(context().changes);
         returnFocus(source, event, value);
     }
     else if (event == ENCODER_EVENT::TURNED)
+        turnHandler(source, value == 1 ? 1 : -1);
+}
+
+void MenuDropDownListValue::turnHandler(ENCODER_SOURCE source, long delta)
+{
+    // Change value
+    int itemCount = list.count();
+
+    if (this->value && itemCount > 0)
     {
-        // Change value
-        if (this->value && listItems && itemCount > 0)
-        {
-            *(this->value) += value == 1 ? 1 : -1;
-            if (*(this->value) < 0)
-                *(this->value) = 0;
-            else if (*(this->value) >= itemCount)
-                *(this->value) = itemCount - 1;
+        *(this->value) += delta;
+        if (*(this->value) < 0)
+            *(this->value) = 0;
+        else if (*(this->value) >= itemCount)
+            *(this->value) = itemCount - 1;
+        notify.update(context().changes);
+        displayValue();
+    }
+}
+
+// A stored choice may be from a longer list
+void MenuDropDownListValue::restored()
+{
+    *value = constrain(*value, 0, max(list.count() - 1, 0));
+}
+
+// Call this when the provider's list has changed (see MenuListSource), so entries which have
+// been kept for redrawing are asked for again
+void MenuDropDownListValue::listChanged()
+{
+    for (int i = 0; MenuContext *ctx = MenuContext::begun(i); i++)
+    {
+        MenuContext::Use use(*ctx);
+        MenuLock lock(*ctx);
+
+        ctx->lists.forget(this);
+        if (ctx->current() == this)
             displayValue();
-        }
     }
 }
 
 MenuRotaryListValue::MenuRotaryListValue(const char *dispText, const char **listItems, int *value) : MenuSystem(dispText)
 {
-    this->listItems = (char **)listItems;
-    for (itemCount = 0; this->listItems[itemCount] != nullptr; itemCount++)
+    int itemCount;
+
+    for (itemCount = 0; listItems[itemCount] != nullptr; itemCount++)
         ;
+    this->list = MenuListSource(listItems, itemCount);
     this->value = value;
-    this->type = MENU_ITEM_TYPE::ROTARY_LIST_VALUE;
-
-    char temp[15];
-    for (int i = 0; i < itemCount; i++)
-    {
-        if (strlen(this->listItems[i]) > 14)
-        {
-            // Try to AVOID using overly long strings as this will INCREASE RAM usage
-            // by creating multiple copies of the string in RAM.  These will NOT be freed
-            // until the menu system is destroyed (which is never in the current implementation).
-            // That's because menu objects need to be permanent (not constucted on the stack) so that
-            // they remain valid while the menu system is in use.
-            memcpy(temp, listItems[i], 14 * sizeof(char));
-            temp[14] = 0;
-            this->listItems[i] = (char *)malloc(15 * sizeof(char));
-            memcpy(this->listItems[i], temp, 15 * sizeof(char));
-        }
-        else
-            this->listItems[i] = (char *)listItems[i];
-    }
     typeIndicator = '\003'; // Rotary symbol indicates rotary selection
 }
 
@@ -564,65 +1368,84 @@ void MenuRotaryListValue::display(int row, bool select)
 
 void MenuRotaryListValue::displayValue()
 {
-    char outputText[17];
+    MenuContext &ctx = context();
+
+    MENU_STAT(ctx.drawing(kind()));
+    if (*value >= list.count())
+        *value = list.count() - 1;
     if (*value < 0)
         *value = 0;
-    if (*value >= itemCount)
-        *value = itemCount - 1;
-    sprintf(outputText, "%c%-14s%c", selected ? '>' : ' ', listItems[*value], selected ? typeIndicator : ' ');
-    lcd->setCursor(0, this->row);
-    lcd->print(outputText);
+    ctx.frame.row(this->row).put(selected ? '>' : ' ').field(ctx.lists.text(this, list, *value), -1, ctx.dispWidth - 2).put(selected ? ctx.symbol(typeIndicator) : ' ');
 }
 
 void MenuRotaryListValue::takeFocus()
 {
-    prevMenu = currentMenu;
-    currentMenu = this;
+    context().push(this);
 
+    notify.editing(context().changes, this, value, sizeof(*value));
     this->inputHandler(ENCODER_SOURCE::A, ENCODER_EVENT::PRESSED, 1000); // Force display of value
 }
 
 void MenuRotaryListValue::inputHandler(ENCODER_SOURCE source, ENCODER_EVENT event, unsigned long value)
 {
+    MenuContext &ctx = context();
+
     if (event == ENCODER_EVENT::TURNED)
     {
         // Exit menu
+        notify.commit(ctx.changes);
         returnFocus(source, event, value);
     }
     else if (event == ENCODER_EVENT::PRESSED)
     {
         // Change value
-        if (this->value && listItems && itemCount > 0)
+        if (this->value && list.count() > 0)
         {
             *(this->value) += 1;
-            if (*(this->value) >= itemCount)
+            if (*(this->value) >= list.count())
                 *(this->value) = 0;
+            notify.update(ctx.changes);
             displayValue();
         }
     }
 }
 
+void MenuRotaryListValue::restored()
+{
+    *value = constrain(*value, 0, max(list.count() - 1, 0));
+}
+
+void MenuRotaryListValue::listChanged()
+{
+    for (int i = 0; MenuContext *ctx = MenuContext::begun(i); i++)
+    {
+        MenuLock lock(*ctx);
+
+        ctx->lists.forget(this);
+    }
+}
+
 typedef void (*action_function_t)(MenuSystem *, ENCODER_SOURCE, ENCODER_EVENT, unsigned long, MenuSystem *);
 typedef void (*input_handler_function_t)(ENCODER_SOURCE, ENCODER_EVENT, unsigned long, MenuSystem *);
 MenuAction::MenuAction(const char *dispText, action_function_t function, input_handler_function_t inputHandlerFunction) : MenuSystem(dispText)
 {
     this->function = function;
     this->inputHandlerFunction = inputHandlerFunction;
-    this->type = MENU_ITEM_TYPE::FUNCTION;
     typeIndicator = '\004';
 }
 
 void MenuAction::takeFocus()
 {
-    prevMenu = currentMenu;
-    currentMenu = this;
+    context().push(this);
 
+    invalidateDisplay(); // The function draws directly to the LCD, so repaint everything when a menu next takes over
     function(this, ENCODER_SOURCE::A, ENCODER_EVENT::PRESSED, 0, nullptr); // Call the function associated with this menu item (indicate we just took focus)
 }
 
 void MenuAction::retakeFocus(MenuSystem *returningMenu, ENCODER_SOURCE source, ENCODER_EVENT event, unsigned long value)
 {
-    currentMenu = this;
+    context().push(this);
+    invalidateDisplay();
     function(this, source, event, value, returningMenu); // Call the function associated with this menu item (indicate we are retaking focus)
 }
 
@@ -634,3 +1457,138 @@ void MenuAction::inputHandler(ENCODER_SOURCE source, ENCODER_EVENT event, unsign
         // Exit menu
         returnFocus(source, event, value);
 }
+
+// True if item's row in a menu shows its value, rather than just its label
+bool MenuSystem::showsValue(MenuSystem *item)
+{
+    return item && (item->kind() == MENU_ITEM_TYPE::WATCH_VALUE || item->kind() == MENU_ITEM_TYPE::ROTARY_LIST_VALUE);
+}
+
+// True if item is a MenuWatchValue whose value has changed (see refresh())
+bool MenuSystem::watchChanged(MenuSystem *item)
+{
+    return item && item->kind() == MENU_ITEM_TYPE::WATCH_VALUE && static_cast<MenuWatchValue *>(item)->changed();
+}
+
+// True if the value is due to be sampled, and has changed since it was drawn
+bool MenuWatchValue::changed()
+{
+    unsigned long now = millis();
+
+    if (now - lastSample < interval)
+        return false;
+    lastSample = now;
+    return read() != drawn;
+}
+
+// The label, then the value right-aligned (the label is clipped if there isn't room for both)
+void MenuWatchValue::display(int row, bool select)
+{
+    MenuContext &ctx = context();
+    char text[MENU_SYSTEM_MAX_COLS];
+    MenuFormatter value(text, ctx.dispWidth - 2);
+    int length;
+
+    MENU_STAT(ctx.drawing(kind()));
+    drawn = read();
+    lastSample = millis();
+    format(value);
+    length = min(value.col(), ctx.dispWidth - 2);
+    ctx.frame.row(row).put(select ? '>' : ' ').field(dispText, dispLength, ctx.dispWidth - 2 - length).put(' ').text(text, length);
+}
+
+unsigned long MenuWatchLong::read()
+{
+    sampled = getter ? getter() : value ? *value : 0;
+    return (unsigned long)sampled;
+}
+
+void MenuWatchLong::format(MenuFormatter &out)
+{
+    out.fixed(sampled, decimals);
+    if (units.length)
+        out.units(units);
+}
+
+unsigned long MenuWatchText::read()
+{
+    uint32_t hash = 2166136261UL; // FNV-1a - the text may have changed in place
+
+    sampled = getter ? getter() : value ? *value : nullptr;
+    if (sampled)
+        for (const char *c = sampled; *c && c - sampled < MENU_SYSTEM_MAX_COLS; c++)
+            hash = (hash ^ (uint8_t)*c) * 16777619UL;
+    return hash;
+}
+
+void MenuWatchText::format(MenuFormatter &out)
+{
+    out.text(sampled ? sampled : naStr);
+}
+
+MenuDashboard::MenuDashboard(const char *dispText, MenuSystem **items) : MenuSystem(dispText)
+{
+    this->items = items;
+    for (itemCount = 0; this->items[itemCount] != nullptr; itemCount++)
+        ;
+    typeIndicator = '\002';
+}
+
+void MenuDashboard::displayValue()
+{
+    MenuContext &ctx = context();
+
+    MENU_STAT(ctx.drawing(kind()));
+    for (int row = 1; row < ctx.dispHeight; row++)
+    {
+        int index = firstIndex + row - 1;
+
+        MENU_STAT(ctx.frame.pen = kind());
+        if (index < itemCount)
+            items[index]->display(row, false);
+        else
+            ctx.frame.row(row).padTo(ctx.dispWidth);
+    }
+}
+
+void MenuDashboard::takeFocus()
+{
+    MenuContext &ctx = context();
+
+    firstIndex = 0;
+    MenuSystem::takeFocus();
+    MENU_STAT(ctx.frame.pen = kind());
+    ctx.frame.put(ctx.dispWidth - 1, 0, ctx.symbol('\001')); // 1 is the return symbol
+}
+
+void MenuDashboard::inputHandler(ENCODER_SOURCE source, ENCODER_EVENT event, unsigned long value)
+{
+    if (event == ENCODER_EVENT::PRESSED)
+        returnFocus(source, event, value);
+    else if (event == ENCODER_EVENT::TURNED)
+        turnHandler(source, value == 1 ? 1 : -1);
+}
+
+// Scroll, if there are more items than rows
+void MenuDashboard::turnHandler(ENCODER_SOURCE source, long delta)
+{
+    int first = constrain(firstIndex + delta, 0L, (long)max(0, itemCount - (context().dispHeight - 1)));
+
+    if (first != firstIndex)
+    {
+        firstIndex = first;
+        displayValue();
+    }
+}
+
+// Redraw the rows whose values have changed
+void MenuDashboard::refresh()
+{
+    for (int row = 1; row < context().dispHeight; row++)
+    {
+        int index = firstIndex + row - 1;
+
+        if (index < itemCount && watchChanged(items[index]))
+            items[index]->display(row, false);
+    }
+}
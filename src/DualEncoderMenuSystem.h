@@ -4,6 +4,20 @@
 #include <Arduino.h>
 #include <LiquidCrystal_I2C.h>
 #include <ESP32RotaryEncoder.h>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include "MenuConfig.h"
+#include "MenuTransport.h"
+#include "MenuTask.h"
+#include "MenuFrameBuffer.h"
+#include "MenuGlyphCache.h"
+#include "MenuEventQueue.h"
+#include "MenuAcceleration.h"
+#include "MenuNotify.h"
+#include "MenuSettings.h"
+#include "MenuList.h"
+#include "MenuTree.h"
 
 enum ENCODER_SOURCE
 {
@@ -17,7 +31,7 @@ enum ENCODER_EVENT
     PRESSED
 };
 
-enum MENU_ITEM_TYPE
+enum MENU_ITEM_TYPE : uint8_t
 {
     NONE,
     MENU,
@@ -26,132 +40,567 @@ enum MENU_ITEM_TYPE
     LONG_VALUE,
     SMALL_FLOAT_VALUE,
     DROP_DOWN_LIST_VALUE,
-    ROTARY_LIST_VALUE
+    ROTARY_LIST_VALUE,
+    FIXED_VALUE,
+    WATCH_VALUE,
+    DASHBOARD,
+    DYNAMIC_MENU,
+    MENU_ITEM_TYPE_COUNT
 };
 
-class MenuSystem
+#if MENU_SYSTEM_STATS
+struct MenuClassStats
+{
+    unsigned long displayCalls; // displayValue() calls
+    unsigned long cellsWritten; // Characters sent to the LCD in the rows this class drew
+    unsigned long busBytes;     // I2C bytes (characters & cursor moves) sent for those rows
+};
+
+struct MenuSystemStats
+{
+    MenuClassStats classes[MENU_ITEM_TYPE_COUNT];
+    unsigned long events;             // Encoder events dispatched by poll()
+    unsigned long latencyMin;         // us from encoder callback to the end of the flush which displayed its result
+    unsigned long latencyMax;         // (worst case since last reset)
+    unsigned long long latencyTotal;
+    unsigned long flushes;            // flush() calls which wrote something to the LCD
+    unsigned long flushMicrosMax;     // Longest single flush (us)
+    unsigned long flushBytesMax;      // Most I2C bytes sent by a single flush
+    unsigned long flushesCut;         // Flushes which used up their byte budget, leaving changes for the next frame
+    unsigned long glyphBytes;         // I2C bytes sent loading custom characters (with the frames, or for a MenuAction)
+    unsigned long screensRestored;    // Menus returned to whose screen was put back from the cache, rather than drawn again
+};
+#endif
+
+class MenuSystem;
+
+// One menu session: its display & encoders, the item with focus (and those to return to), the frame
+// being drawn, the render limits & task, and the statistics.  MenuSystem::begin(), poll() etc. work on
+// a default context (MenuContext::primary); declare one of these for each other session - e.g. a
+// second display with its own pair of encoders - and call its own begin(), poll() etc.  Each context
+// has its own lock & render task, so they can be run from different tasks or cores without waiting
+// for each other (give each its own items, if they do).  An item can be in several of a context's
+// menus: it doesn't hold where it was opened from, the context's focus stack does.
+class MenuContext
 {
 protected:
-    MENU_ITEM_TYPE type = MENU_ITEM_TYPE::NONE;
+    MenuSystem *focus[MENU_SYSTEM_FOCUS_DEPTH] = {}; // The item with focus, on top of those it returns to
+    int focusDepth = 0;
+#if MENU_SYSTEM_SCREEN_CACHE_DEPTH
+    MenuScreen screens[MENU_SYSTEM_SCREEN_CACHE_DEPTH]; // The screen of each of the lowest levels, as it was when
+    bool screenSaved[MENU_SYSTEM_SCREEN_CACHE_DEPTH] = {}; // the item above it took focus (see restoreScreen())
+#endif
+    MenuMutex mutex;
+    MenuRenderTask renderTask;
+    MenuLiquidCrystalTransport liquidCrystalTransport; // Used when begin() is given a LiquidCrystal_I2C
+    int slot = -1; // Which of the encoder callbacks are ours (see begin())
 
-    static int dispHeight;
-    static int dispWidth;
-    static LiquidCrystal_I2C *lcd;
-    static RotaryEncoder *encoderA;
-    static RotaryEncoder *encoderB;
-    static bool initialised;
+    static thread_local MenuContext *bound; // The context in use by this task (see Use)
+    static MenuContext *slots[MENU_SYSTEM_MAX_CONTEXTS];
 
-    MenuSystem *prevMenu = nullptr;
-    char typeIndicator = 0x7E; // Indicates action (up arrow (\001 return) = return, down arrow (\002 enter) = enter menu/function, right arrow  (->) = edit value)
+    // The encoder callbacks for each slot - they only queue the event (all menu work is done from poll())
+    template <int slot, ENCODER_SOURCE source>
+    static void turned(long value) { slots[slot]->events.push(source, ENCODER_EVENT::TURNED, value); }
+    template <int slot, ENCODER_SOURCE source>
+    static void pressed(unsigned long value) { slots[slot]->events.push(source, ENCODER_EVENT::PRESSED, value); }
+
+    static constexpr unsigned long frameMillis(unsigned int framesPerSecond) { return framesPerSecond ? 1000 / framesPerSecond : 0; }
+    static uint32_t renderFrom(MenuContext *context, bool all);
+
+    friend class MenuLock;
+
+public:
+    // The state the menu items draw & dispatch with, while the context is in use (see active())
+    int dispWidth = 0;
+    int dispHeight = 0;
+    MenuDisplayTransport *lcd = nullptr;
+    RotaryEncoder *encoderA = nullptr;
+    RotaryEncoder *encoderB = nullptr;
+    bool initialised = false;
+    MenuFrameBuffer frame;
+    MenuEventQueue events;
+    MenuGlyphCache glyphs;
+    MenuListCache lists;
+    MenuAccelerator accelerator;
+    MenuValueChanges changes; // The value being edited, and the onChange() calls waiting for poll()
+    unsigned long turnTime = 0;  // micros() of the last detent of the turn being handled (see dispatchTurn())
+    unsigned long frameInterval;                 // ms (0 = no frame rate limit)
+    unsigned int frameBudget;                    // Bus bytes per frame (0 = no limit)
+    unsigned long lastFrame = 0;
+#if MENU_SYSTEM_STATS
+    MenuSystemStats stats = {};
+
+    // Encoder callback times for the events handled by the current poll(), so their latency
+    // can be recorded once the LCD has been updated
+    unsigned long batchFirst = 0;
+    unsigned long batchLast = 0;
+    unsigned long batchCount = 0;
+    unsigned long long batchOffsets = 0; // Sum of (event time - batchFirst)
+
+    // Count a displayValue() (or display()) call, and put what's drawn next down to type (see sendFrame())
+    void drawing(MENU_ITEM_TYPE type)
+    {
+        stats.classes[type].displayCalls++;
+        frame.pen = type;
+    }
+#endif
+
+    static MenuContext primary;
+    static MenuContext *settingsContext; // The one whose poll() keeps the saved settings up to date
+
+    // Puts a context in use by the calling task for as long as it's held: poll(), the render task etc.
+    // hold one while the items draw & handle input, so they (and your MenuAction functions) use the
+    // right display.  Hold one yourself to take focus in a context from outside its callbacks.
+    class Use
+    {
+    protected:
+        MenuContext *previous;
+
+    public:
+        explicit Use(MenuContext &context) : previous(bound) { bound = &context; }
+        ~Use() { bound = previous; }
+    };
 
+    static MenuContext &active() { return bound ? *bound : primary; }
+    static MenuContext *begun(int index) { return index >= 0 && index < MENU_SYSTEM_MAX_CONTEXTS ? slots[index] : nullptr; } // (nullptr after the last)
+
+    MenuContext();
+    void begin(int dispWidth, int dispHeight, LiquidCrystal_I2C *lcd, RotaryEncoder *encoderA, RotaryEncoder *encoderB);
+    void begin(int dispWidth, int dispHeight, MenuDisplayTransport *display, RotaryEncoder *encoderA, RotaryEncoder *encoderB);
+    void start(MenuSystem *item);
+    void poll();
+    void flush();
+    void setRenderLimits(unsigned int maxFramesPerSecond, unsigned int frameByteBudget);
+    bool startRenderTask(int core = 0, int priority = 1, uint32_t stackSize = 4096);
+    void stopRenderTask();
+    void printStats(Print &out = Serial);
+    void resetStats();
+    void printFootprint(const MenuSystem *root = nullptr, Print &out = Serial);
+    void invalidateDisplay();
+    char glyph(const uint8_t bitmap[8], char fallback = ' ');
+
+    void dispatchTurn(ENCODER_SOURCE source, long delta, unsigned long time);
+    uint32_t render(bool all);
+    int sendFrame(unsigned int byteBudget);
+    int sendGlyphs(unsigned int byteBudget, unsigned int &spent);
+    bool displayUpToDate();
+    char symbol(char c);
+
+    // The focus stack (see MenuSystem::takeFocus() & returnFocus())
+    MenuSystem *current() const { return focusDepth ? focus[focusDepth - 1] : nullptr; }
+    MenuSystem *parentOf(const MenuSystem *item) const;
+    void push(MenuSystem *item);
+    bool restoreScreen(const MenuSystem *item);
+};
+
+class MenuSystem
+{
 public:
-    char *dispText = nullptr;
+    // (The members are in size order, so the few bytes of each item which are in RAM are packed - and the
+    // padding after the last of them can take a derived item's first small members)
+    const char *dispText = nullptr;
+    uint8_t dispLength = 0;
+
+protected:
+    char typeIndicator = 0x7E; // Indicates action (up arrow (\001 return) = return, down arrow (\002 enter) = enter menu/function, right arrow  (->) = edit value)
+
+    static MenuSettings settings;
+
+    static MenuContext &context() { return MenuContext::active(); }
+    static bool watchChanged(MenuSystem *item);
+    static bool showsValue(MenuSystem *item);
+    MenuSystem *parent() const { return context().parentOf(this); } // The item focus returns to (nullptr if none)
+
+    friend class MenuContext;
+
+    constexpr MenuSystem(char typeIndicator, const MenuLabel &dispText)
+        : dispText(dispText.text), dispLength(dispText.length), typeIndicator(typeIndicator) {}
 
+public:
     static void encoderAturned(long value);
     static void encoderApressed(unsigned long value);
     static void encoderBturned(long value);
     static void encoderBpressed(unsigned long value);
     static void begin(int dispWidth, int dispHeight, LiquidCrystal_I2C *lcd, RotaryEncoder *encoderA, RotaryEncoder *encoderB);
+    static void begin(int dispWidth, int dispHeight, MenuDisplayTransport *display, RotaryEncoder *encoderA, RotaryEncoder *encoderB);
+    static void poll();
+    static void flush();
+    static void setRenderLimits(unsigned int maxFramesPerSecond, unsigned int frameByteBudget);
+    static bool startRenderTask(int core = 0, int priority = 1, uint32_t stackSize = 4096);
+    static void stopRenderTask();
+    static int queueDepth();
+    static int queueMaxDepth();
+    static unsigned long queueOverflows();
+    static void resetQueueStats();
+#if MENU_SYSTEM_STATS
+    static const MenuSystemStats &getStats() { return context().stats; }
+#endif
+    static void printStats(Print &out = Serial);
+    static void resetStats();
+    static void printFootprint(const MenuSystem *root = nullptr, Print &out = Serial);
+    static void invalidateDisplay();
+    static char glyph(const uint8_t bitmap[8], char fallback = ' ');
+    static bool beginSettings(MenuStorage *storage, uint32_t commitDelay = 10000);
+    static bool saveSettings();
 
     MenuSystem(const char *dispText);
+    constexpr MenuSystem(const MenuLabel &dispText) : MenuSystem(0x7E, dispText) {}
     virtual void display(int row, bool select);
     virtual void displayValue();
     virtual void takeFocus();
     virtual void returnFocus(ENCODER_SOURCE source, ENCODER_EVENT event, unsigned long value);
     virtual void retakeFocus(MenuSystem *returningMenu, ENCODER_SOURCE source, ENCODER_EVENT event, unsigned long value);
     virtual void inputHandler(ENCODER_SOURCE source, ENCODER_EVENT event, unsigned long value) {};
+    virtual void turnHandler(ENCODER_SOURCE source, long delta);
+    virtual void refresh() {} // Called by poll() for the item with focus, to redraw live values
+    virtual void restored() {} // Called when beginSettings() has changed the item's value
+    virtual size_t footprint() const { return sizeof(*this); } // The RAM the item takes (see printFootprint())
+    virtual MENU_ITEM_TYPE kind() const { return MENU_ITEM_TYPE::NONE; } // What sort of item it is (for the statistics, and the footprint report)
+    virtual MenuSystem *const *children(int &count) const { count = 0; return nullptr; } // The items it leads to (a Menu's entries...)
 };
 
 class Menu : public MenuSystem
 {
 protected:
-    MenuSystem **menuItems = nullptr;
+    MenuSystem *const *menuItems = nullptr;
     int itemCount = 0;
     int selectedIndex = -1;
+    int topIndex = -1; // First entry shown (see displayValue())
+
+    void displayEntry(int index, int row);
+    bool scrollToSelection();
+    virtual MenuSystem *item(int index) { return menuItems[index]; }
+
+    Menu(const char *dispText) : MenuSystem(dispText) {}
+    constexpr Menu(const MenuLabel &dispText) : MenuSystem('\002', dispText) {}
 
 public:
     Menu(const char *dispText, MenuSystem **menuItems);
+    constexpr Menu(const MenuLabel &dispText, const MenuItemList &menuItems)
+        : MenuSystem('\002', dispText), menuItems(menuItems.items), itemCount(menuItems.count) {}
     void displayValue() override;
     void takeFocus() override;
     void retakeFocus(MenuSystem *returningMenu, ENCODER_SOURCE source, ENCODER_EVENT event, unsigned long value) override;
     void inputHandler(ENCODER_SOURCE source, ENCODER_EVENT event, unsigned long value) override;
+    void turnHandler(ENCODER_SOURCE source, long delta) override;
+    void refresh() override;
+    size_t footprint() const override { return sizeof(*this); }
+    MENU_ITEM_TYPE kind() const override { return MENU_ITEM_TYPE::MENU; }
+    MenuSystem *const *children(int &count) const override { count = itemCount; return menuItems; }
+};
+
+// Room for one item of a MenuDynamic, which its generator builds the item in with make()
+class MenuItemSlot
+{
+protected:
+    alignas(8) uint8_t storage[MENU_SYSTEM_DYNAMIC_ITEM_SIZE];
+    MenuSystem *item = nullptr;
+    int index = -1; // The entry it holds (-1 = free)
+
+    friend class MenuDynamic;
+
+public:
+    char label[MENU_SYSTEM_MAX_COLS + 1]; // For the item's label, if it's made up (e.g. "Profile 3")
+
+    // Build a T (any of the menu item classes) in the slot, e.g. slot.make<MenuLongValue>(slot.label, "rpm", 0, 2000, 100, 10, &speed)
+    template <class T, class... Args>
+    T *make(Args &&...args)
+    {
+        static_assert(sizeof(T) <= MENU_SYSTEM_DYNAMIC_ITEM_SIZE, "Item too big for a MenuItemSlot - raise MENU_SYSTEM_DYNAMIC_ITEM_SIZE");
+        static_assert(std::is_trivially_destructible<T>::value, "MenuItemSlot items are reused without being destroyed");
+        T *made = new (storage) T(std::forward<Args>(args)...);
+        item = made;
+        return made;
+    }
+};
+
+// Supplies the entries of a MenuDynamic
+class MenuItemGenerator
+{
+public:
+    virtual int count() = 0;
+    virtual MenuSystem *build(int index, MenuItemSlot &slot) = 0; // Return slot.make<...>(...) for entry index
+};
+
+// A Menu whose entries are built as they're needed by a generator - e.g. one for each stored profile.
+// Only the entries on the display exist (each in one of MENU_SYSTEM_MAX_ROWS slots, reused as the
+// menu scrolls), so the RAM used doesn't depend on how many entries there are.  The count is taken,
+// and the entries built afresh, each time the menu takes focus; the slots are given up when it
+// returns focus.  (Don't persist() a generated item, or give it an onChange() - it doesn't last.)
+class MenuDynamic : public Menu
+{
+protected:
+    MenuItemGenerator *generator = nullptr;
+    MenuItemSlot slots[MENU_SYSTEM_MAX_ROWS];
+
+    MenuSystem *item(int index) override;
+    void release();
+
+public:
+    MenuDynamic(const char *dispText, MenuItemGenerator *generator);
+    MenuDynamic(const MenuLabel &dispText, MenuItemGenerator *generator) : Menu(dispText), generator(generator) {}
+    void takeFocus() override;
+    void returnFocus(ENCODER_SOURCE source, ENCODER_EVENT event, unsigned long value) override;
+    void itemsChanged();
+    size_t footprint() const override { return sizeof(*this); }
+    MENU_ITEM_TYPE kind() const override { return MENU_ITEM_TYPE::DYNAMIC_MENU; }
+    MenuSystem *const *children(int &count) const override { count = 0; return nullptr; } // (Its items are built in its slots)
 };
 
 class MenuBoolValue : public MenuSystem
 {
 protected:
-    char *falseOption = nullptr;
-    char *trueOption = nullptr;
+    MenuTextView falseOption;
+    MenuTextView trueOption;
     bool *value = nullptr;
+    MenuValueNotifier notify;
 
 public:
     MenuBoolValue(const char *dispText, const char *falseOption, const char *trueOption, bool *value);
+    constexpr MenuBoolValue(const MenuLabel &dispText, const MenuOption &trueOption, const MenuOption &falseOption, bool *value)
+        : MenuSystem(0x7E, dispText), falseOption(falseOption), trueOption(trueOption), value(value) {}
     void displayValue() override;
     void takeFocus() override;
     void inputHandler(ENCODER_SOURCE source, ENCODER_EVENT event, unsigned long value) override;
+    void turnHandler(ENCODER_SOURCE source, long delta) override;
+    void onChange(value_callback_t callback, uint16_t minInterval = 0) { notify.onChange(callback, minInterval); }
+    void onCommit(value_callback_t callback) { notify.onCommit(callback); }
+    bool persist(uint16_t key) { return settings.add(key, this, value, sizeof(*value)); }
+    size_t footprint() const override { return sizeof(*this); }
+    MENU_ITEM_TYPE kind() const override { return MENU_ITEM_TYPE::BOOL_VALUE; }
+};
+
+// The fixed properties of a long value editor - its units, limits & steps.  Declared constexpr (see
+// MENU_LONG_VALUE()), a descriptor is left in flash, and all the item keeps in RAM is a pointer to it
+// (and its own state) - which adds up when a machine has hundreds of parameters.
+struct MenuLongSpec
+{
+    MenuTextView units;
+    long minValue;
+    long maxValue;
+    long coarseStep;
+    long fineStep;
+
+    constexpr MenuLongSpec(const MenuTextView &units = MenuTextView(), long minValue = 0, long maxValue = 0, long coarseStep = 100, long fineStep = 1)
+        : units(units), minValue(minValue < maxValue ? minValue : maxValue), maxValue(minValue < maxValue ? maxValue : minValue),
+          coarseStep(coarseStep > 0 ? coarseStep : 100), fineStep(fineStep > 0 ? fineStep : 1) {}
 };
 
-class MenuLongValue : public MenuSystem
+// As MenuLongSpec, for a float
+struct MenuFloatSpec
+{
+    MenuTextView units;
+    float minValue;
+    float maxValue;
+    float coarseStep;
+    float fineStep;
+
+    constexpr MenuFloatSpec(const MenuTextView &units = MenuTextView(), float minValue = 0.0, float maxValue = 0.0, float coarseStep = 0.1f, float fineStep = 0.001f)
+        : units(units), minValue(minValue < maxValue ? minValue : maxValue), maxValue(minValue < maxValue ? maxValue : minValue),
+          coarseStep(coarseStep > 0 ? coarseStep : 0.1f), fineStep(fineStep > 0 ? fineStep : 0.001f) {}
+};
+
+// Scale factor and (compile-time) conversion for MenuFixedValue values, e.g. menuFixed(0.355, 3) == 355
+constexpr long menuFixedScale(uint8_t decimals) { return decimals ? 10 * menuFixedScale(decimals - 1) : 1; }
+constexpr long menuFixed(double value, uint8_t decimals) { return (long)(value * menuFixedScale(decimals) + (value < 0 ? -0.5 : 0.5)); }
+
+// As MenuLongSpec, for a fixed-point number (see MenuFixedValue)
+struct MenuFixedSpec
+{
+    MenuTextView units;
+    long minValue;
+    long maxValue;
+    long coarseStep;
+    long fineStep;
+    uint8_t decimals;
+
+    constexpr MenuFixedSpec(const MenuTextView &units = MenuTextView(), uint8_t decimals = 0, long minValue = 0, long maxValue = 0, long coarseStep = 100, long fineStep = 1)
+        : units(units), minValue(minValue < maxValue ? minValue : maxValue), maxValue(minValue < maxValue ? maxValue : minValue),
+          coarseStep(coarseStep > 0 ? coarseStep : 100), fineStep(fineStep > 0 ? fineStep : 1), decimals(decimals < 9 ? decimals : 9) {}
+};
+
+// What the numeric editors share: a T edited within the limits & with the steps of a Spec (one of the
+// descriptors above) - each step a coarse or fine one, depending on the encoder, optionally accelerated.
+// Only how the value is shown differs (see menuFormatNumber()).  The three kinds are instantiated in the library.
+template <class T, class Spec>
+class MenuNumberEditor : public MenuSystem
 {
 protected:
-    char *units = nullptr;
-    long *value = nullptr;
-    long minValue = 0;
-    long maxValue = 0;
-    long coarseStep = 100;
-    long fineStep = 1;
+    const Spec *spec;
+    T *value = nullptr;
+
+    const MenuAccelerationProfile *acceleration = nullptr;
+    MenuValueNotifier notify;
+
+    MenuNumberEditor(const char *dispText, const Spec &spec, T *value) : MenuSystem(dispText), spec(&spec), value(value) {}
+    constexpr MenuNumberEditor(const MenuLabel &dispText, const Spec &spec, T *value)
+        : MenuSystem(0x7E, dispText), spec(&spec), value(value) {}
 
 public:
-    MenuLongValue(const char *dispText, const char *units, long minValue, long maxValue, long coarseStep, long fineStep, long *value);
     void displayValue() override;
+    void takeFocus() override;
     void inputHandler(ENCODER_SOURCE source, ENCODER_EVENT event, unsigned long value) override;
+    void turnHandler(ENCODER_SOURCE source, long delta) override;
+    void setAcceleration(const MenuAccelerationProfile *profile = &menuDefaultAcceleration);
+    void onChange(value_callback_t callback, uint16_t minInterval = 0) { notify.onChange(callback, minInterval); }
+    void onCommit(value_callback_t callback) { notify.onCommit(callback); }
+    void restored() override;
+    bool persist(uint16_t key) { return settings.add(key, this, value, sizeof(*value)); }
+};
+
+extern template class MenuNumberEditor<long, MenuLongSpec>;
+extern template class MenuNumberEditor<float, MenuFloatSpec>;
+extern template class MenuNumberEditor<long, MenuFixedSpec>;
+
+// Edits a long, within the limits & with the steps of a MenuLongSpec (MenuLongValue brings its own)
+class MenuLongEditor : public MenuNumberEditor<long, MenuLongSpec>
+{
+public:
+    MenuLongEditor(const char *dispText, const MenuLongSpec &spec, long *value) // (e.g. labels made up at run time, sharing a descriptor)
+        : MenuNumberEditor(dispText, spec, value) {}
+    constexpr MenuLongEditor(const MenuLabel &dispText, const MenuLongSpec &spec, long *value)
+        : MenuNumberEditor(dispText, spec, value) {}
+    size_t footprint() const override { return sizeof(*this); }
+    MENU_ITEM_TYPE kind() const override { return MENU_ITEM_TYPE::LONG_VALUE; }
+};
+
+class MenuLongValue : public MenuLongEditor
+{
+protected:
+    MenuLongSpec own;
+
+public:
+    MenuLongValue(const char *dispText, const char *units, long minValue, long maxValue, long coarseStep, long fineStep, long *value);
+    constexpr MenuLongValue(const MenuLabel &dispText, const MenuLabel &units, long minValue, long maxValue, long coarseStep, long fineStep, long *value)
+        : MenuLongEditor(dispText, own, value), own(units, minValue, maxValue, coarseStep, fineStep) {}
+    MenuLongValue(const MenuLongValue &) = delete; // (spec points at own, so a copy's would point at the original's)
+    MenuLongValue &operator=(const MenuLongValue &) = delete;
+    size_t footprint() const override { return sizeof(*this); }
 };
 
-class MenuFloatValue : public MenuSystem
+class MenuFloatEditor : public MenuNumberEditor<float, MenuFloatSpec>
+{
+public:
+    MenuFloatEditor(const char *dispText, const MenuFloatSpec &spec, float *value)
+        : MenuNumberEditor(dispText, spec, value) {}
+    constexpr MenuFloatEditor(const MenuLabel &dispText, const MenuFloatSpec &spec, float *value)
+        : MenuNumberEditor(dispText, spec, value) {}
+    size_t footprint() const override { return sizeof(*this); }
+    MENU_ITEM_TYPE kind() const override { return MENU_ITEM_TYPE::SMALL_FLOAT_VALUE; }
+};
+
+class MenuFloatValue : public MenuFloatEditor
 {
 protected:
-    char *units = nullptr;
-    float *value = nullptr;
-    float minValue = 0.0;
-    float maxValue = 0.0;
-    float coarseStep = 0.01;
-    float fineStep = 0.001;
+    MenuFloatSpec own;
 
 public:
     MenuFloatValue(const char *dispText, const char *units, float minValue, float maxValue, float coarseStep, float fineStep, float *value);
-    void displayValue() override;
-    void inputHandler(ENCODER_SOURCE source, ENCODER_EVENT event, unsigned long value) override;
+    constexpr MenuFloatValue(const MenuLabel &dispText, const MenuLabel &units, float minValue, float maxValue, float coarseStep, float fineStep, float *value)
+        : MenuFloatEditor(dispText, own, value), own(units, minValue, maxValue, coarseStep, fineStep) {}
+    MenuFloatValue(const MenuFloatValue &) = delete; // (spec points at own, so a copy's would point at the original's)
+    MenuFloatValue &operator=(const MenuFloatValue &) = delete;
+    size_t footprint() const override { return sizeof(*this); }
+};
+
+// A number with a fixed number of decimal places, held as a scaled integer (0.355 mm at 3 decimals
+// is stored as 355), so it steps and clamps exactly and is shown without float formatting
+class MenuFixedEditor : public MenuNumberEditor<long, MenuFixedSpec>
+{
+protected:
+    volatile int32_t *published = nullptr;
+
+public:
+    MenuFixedEditor(const char *dispText, const MenuFixedSpec &spec, long *value)
+        : MenuNumberEditor(dispText, spec, value) {}
+    constexpr MenuFixedEditor(const MenuLabel &dispText, const MenuFixedSpec &spec, long *value)
+        : MenuNumberEditor(dispText, spec, value) {}
+    void turnHandler(ENCODER_SOURCE source, long delta) override;
+    void restored() override;
+    void publishTo(volatile int32_t *target);
+    size_t footprint() const override { return sizeof(*this); }
+    MENU_ITEM_TYPE kind() const override { return MENU_ITEM_TYPE::FIXED_VALUE; }
+};
+
+class MenuFixedValue : public MenuFixedEditor
+{
+protected:
+    MenuFixedSpec own;
+
+public:
+    MenuFixedValue(const char *dispText, const char *units, uint8_t decimals, long minValue, long maxValue, long coarseStep, long fineStep, long *value);
+    constexpr MenuFixedValue(const MenuLabel &dispText, const MenuLabel &units, uint8_t decimals, long minValue, long maxValue, long coarseStep, long fineStep, long *value)
+        : MenuFixedEditor(dispText, own, value), own(units, decimals, minValue, maxValue, coarseStep, fineStep) {}
+    MenuFixedValue(const MenuFixedValue &) = delete; // (spec points at own, so a copy's would point at the original's)
+    MenuFixedValue &operator=(const MenuFixedValue &) = delete;
+    size_t footprint() const override { return sizeof(*this); }
 };
 
+// Declare a value editor whose descriptor (units, limits & steps) is left in flash, e.g.
+//     MENU_LONG_VALUE(mmSpeed, "Speed", "rpm", 0, 2000, 100, 10, &speed);
+// The item is used just as a MenuLongValue (mmSpeed.onChange(...), &mmSpeed in MENU_ITEMS(), ...)
+#define MENU_LONG_VALUE(name, label, units, minValue, maxValue, coarseStep, fineStep, value) \
+    constexpr MenuLongSpec name##Spec(MenuLabel(units), minValue, maxValue, coarseStep, fineStep); \
+    MenuLongEditor name(MenuLabel(label), name##Spec, value)
+#define MENU_FLOAT_VALUE(name, label, units, minValue, maxValue, coarseStep, fineStep, value) \
+    constexpr MenuFloatSpec name##Spec(MenuLabel(units), minValue, maxValue, coarseStep, fineStep); \
+    MenuFloatEditor name(MenuLabel(label), name##Spec, value)
+#define MENU_FIXED_VALUE(name, label, units, decimals, minValue, maxValue, coarseStep, fineStep, value) \
+    constexpr MenuFixedSpec name##Spec(MenuLabel(units), decimals, minValue, maxValue, coarseStep, fineStep); \
+    MenuFixedEditor name(MenuLabel(label), name##Spec, value)
+
 class MenuDropDownListValue : public MenuSystem
 {
 protected:
     int *value = nullptr;
-    char **listItems = nullptr;
-    int itemCount = 0;
+    MenuListSource list;
+    MenuValueNotifier notify;
 
 public:
     MenuDropDownListValue(const char *dispText, const char **listItems, int *value);
+    constexpr MenuDropDownListValue(const MenuLabel &dispText, const MenuStringList &listItems, int *value)
+        : MenuSystem(0x7E, dispText), value(value), list(listItems) {}
+    constexpr MenuDropDownListValue(const MenuLabel &dispText, list_count_t countProvider, list_text_t textProvider, int *value)
+        : MenuSystem(0x7E, dispText), value(value), list(countProvider, textProvider) {}
     void displayValue() override;
     void takeFocus() override;
     void inputHandler(ENCODER_SOURCE source, ENCODER_EVENT event, unsigned long value) override;
+    void turnHandler(ENCODER_SOURCE source, long delta) override;
+    void onChange(value_callback_t callback, uint16_t minInterval = 0) { notify.onChange(callback, minInterval); }
+    void onCommit(value_callback_t callback) { notify.onCommit(callback); }
+    void restored() override;
+    bool persist(uint16_t key) { return settings.add(key, this, value, sizeof(*value)); }
+    void listChanged();
+    size_t footprint() const override { return sizeof(*this); }
+    MENU_ITEM_TYPE kind() const override { return MENU_ITEM_TYPE::DROP_DOWN_LIST_VALUE; }
 };
 
 class MenuRotaryListValue : public MenuSystem
 {
 protected:
-    int row = 0;
+    uint8_t row = 0;
     bool selected = false;
     int *value = nullptr;
-    char **listItems = nullptr;
-    int itemCount = 0;
+    MenuListSource list;
+    MenuValueNotifier notify;
 
 public:
     MenuRotaryListValue(const char *dispText, const char **listItems, int *value);
+    constexpr MenuRotaryListValue(const MenuLabel &dispText, const MenuStringList &listItems, int *value)
+        : MenuSystem('\003', dispText), value(value), list(listItems) {}
+    constexpr MenuRotaryListValue(const MenuLabel &dispText, list_count_t countProvider, list_text_t textProvider, int *value)
+        : MenuSystem('\003', dispText), value(value), list(countProvider, textProvider) {}
     void display(int row, bool select) override;
     void displayValue() override;
     void takeFocus() override;
     void inputHandler(ENCODER_SOURCE source, ENCODER_EVENT event, unsigned long value) override;
+    void onChange(value_callback_t callback, uint16_t minInterval = 0) { notify.onChange(callback, minInterval); }
+    void onCommit(value_callback_t callback) { notify.onCommit(callback); }
+    void restored() override;
+    bool persist(uint16_t key) { return settings.add(key, this, value, sizeof(*value)); }
+    void listChanged();
+    size_t footprint() const override { return sizeof(*this); }
+    MENU_ITEM_TYPE kind() const override { return MENU_ITEM_TYPE::ROTARY_LIST_VALUE; }
 };
 
 typedef void (*action_function_t)(MenuSystem *, ENCODER_SOURCE, ENCODER_EVENT, unsigned long, MenuSystem *);
@@ -165,9 +614,111 @@ protected:
 
 public:
     MenuAction(const char *dispText, action_function_t function, input_handler_function_t inputHandlerFunction);
+    constexpr MenuAction(const MenuLabel &dispText, action_function_t function, input_handler_function_t inputHandlerFunction)
+        : MenuSystem('\004', dispText), function(function), inputHandlerFunction(inputHandlerFunction) {}
     void takeFocus() override;
     void retakeFocus(MenuSystem *returningMenu, ENCODER_SOURCE source, ENCODER_EVENT event, unsigned long value) override;
     void inputHandler(ENCODER_SOURCE source, ENCODER_EVENT event, unsigned long value) override;
+    size_t footprint() const override { return sizeof(*this); }
+    MENU_ITEM_TYPE kind() const override { return MENU_ITEM_TYPE::FUNCTION; }
+};
+
+// A read-only, live value (a count, a speed, a status...) with its label, on one row of a Menu or a
+// MenuDashboard.  While it's on the display, poll() samples it every interval ms and redraws it only
+// when it has changed - and then only the characters which differ are sent to the LCD.
+class MenuWatchValue : public MenuSystem
+{
+protected:
+    uint16_t interval = 250;
+    unsigned long lastSample = 0;
+    unsigned long drawn = 0; // Signature of the value last drawn
+
+    constexpr MenuWatchValue(const MenuLabel &dispText, uint16_t interval)
+        : MenuSystem(' ', dispText), interval(interval) {}
+    virtual unsigned long read() = 0; // Samples the value, returning something which changes when it does (as wide as a long, so no change is lost)
+    virtual void format(MenuFormatter &out) = 0;
+
+public:
+    bool changed();
+    void display(int row, bool select) override;
+    void takeFocus() override {} // Nothing to edit (the Menu keeps focus)
+    MENU_ITEM_TYPE kind() const override { return MENU_ITEM_TYPE::WATCH_VALUE; }
+};
+
+// A long (e.g. a count updated by your stepper code), read through a pointer or a getter function
+class MenuWatchLong : public MenuWatchValue
+{
+protected:
+    MenuTextView units;
+    const volatile long *value = nullptr;
+    long (*getter)() = nullptr;
+    uint8_t decimals = 0;
+    long sampled = 0;
+
+    unsigned long read() override;
+    void format(MenuFormatter &out) override;
+    size_t footprint() const override { return sizeof(*this); }
+
+    constexpr MenuWatchLong(const MenuLabel &dispText, const MenuLabel &units, uint8_t decimals, const volatile long *value, long (*getter)(), uint16_t interval)
+        : MenuWatchValue(dispText, interval), units(units), value(value), getter(getter), decimals(decimals < 9 ? decimals : 9) {}
+
+public:
+    constexpr MenuWatchLong(const MenuLabel &dispText, const MenuLabel &units, const volatile long *value, uint16_t interval = 250)
+        : MenuWatchLong(dispText, units, 0, value, nullptr, interval) {}
+    constexpr MenuWatchLong(const MenuLabel &dispText, const MenuLabel &units, long (*getter)(), uint16_t interval = 250)
+        : MenuWatchLong(dispText, units, 0, nullptr, getter, interval) {}
+};
+
+// A fixed-point number held as a scaled long (see MenuFixedValue)
+class MenuWatchFixed : public MenuWatchLong
+{
+public:
+    constexpr MenuWatchFixed(const MenuLabel &dispText, const MenuLabel &units, uint8_t decimals, const volatile long *value, uint16_t interval = 250)
+        : MenuWatchLong(dispText, units, decimals, value, nullptr, interval) {}
+    constexpr MenuWatchFixed(const MenuLabel &dispText, const MenuLabel &units, uint8_t decimals, long (*getter)(), uint16_t interval = 250)
+        : MenuWatchLong(dispText, units, decimals, nullptr, getter, interval) {}
+};
+
+// A string, read through a pointer to your (const char *) variable, or a getter function
+class MenuWatchText : public MenuWatchValue
+{
+protected:
+    const char *const *value = nullptr;
+    const char *(*getter)() = nullptr;
+    const char *sampled = nullptr;
+
+    unsigned long read() override;
+    void format(MenuFormatter &out) override;
+    size_t footprint() const override { return sizeof(*this); }
+
+public:
+    constexpr MenuWatchText(const MenuLabel &dispText, const char *const *value, uint16_t interval = 250)
+        : MenuWatchValue(dispText, interval), value(value) {}
+    constexpr MenuWatchText(const MenuLabel &dispText, const char *(*getter)(), uint16_t interval = 250)
+        : MenuWatchValue(dispText, interval), getter(getter) {}
+};
+
+// A screen of live values (normally MenuWatchValue items), one per row below the title.  Turning
+// either encoder scrolls through them (if there are more than fit), clicking returns.
+class MenuDashboard : public MenuSystem
+{
+protected:
+    MenuSystem *const *items = nullptr;
+    int itemCount = 0;
+    int firstIndex = 0; // Item shown on row 1
+
+public:
+    MenuDashboard(const char *dispText, MenuSystem **items);
+    constexpr MenuDashboard(const MenuLabel &dispText, const MenuItemList &items)
+        : MenuSystem('\002', dispText), items(items.items), itemCount(items.count) {}
+    void displayValue() override;
+    void takeFocus() override;
+    void inputHandler(ENCODER_SOURCE source, ENCODER_EVENT event, unsigned long value) override;
+    void turnHandler(ENCODER_SOURCE source, long delta) override;
+    void refresh() override;
+    size_t footprint() const override { return sizeof(*this); }
+    MENU_ITEM_TYPE kind() const override { return MENU_ITEM_TYPE::DASHBOARD; }
+    MenuSystem *const *children(int &count) const override { count = itemCount; return items; }
 };
 
 #endif // DUAL_ENCODER_MENU_SYSTEM_H
\ No newline at end of file
@@ -0,0 +1,50 @@
+#include "MenuAcceleration.h"
+
+const MenuAccelerationProfile menuDefaultAcceleration = {15, 120, 10, 400, ACCELERATION_CURVE::QUADRATIC};
+
+void MenuAccelerator::reset()
+{
+    owner = nullptr;
+}
+
+// Returns delta (a number of detents) scaled according to how quickly the encoder is turning.
+// time is when the last of them was turned (the micros() the encoder callback queued it at), so
+// the speed is the encoder's own, however long the events waited for poll().  With no profile,
+// delta is returned unchanged.
+long MenuAccelerator::apply(const MenuAccelerationProfile *profile, const void *owner, uint8_t source, long delta, unsigned long time)
+{
+    unsigned long elapsed = (time - lastTime) / 1000; // ms
+    unsigned long detents = delta < 0 ? -delta : delta;
+    unsigned long perDetent;
+    long t, multiplier;
+
+    if (!profile || !delta)
+        return delta;
+
+    lastTime = time;
+    if (owner != this->owner || source != this->source || (delta > 0) != clockwise || elapsed >= profile->idleReset)
+    {
+        // Start again - the first detent(s) are never accelerated
+        this->owner = owner;
+        this->source = source;
+        clockwise = delta > 0;
+        interval = profile->slowInterval;
+        return delta;
+    }
+
+    // Several detents may arrive together (see MenuSystem::poll()), so average over them,
+    // then smooth to stop the multiplier jumping about between detents
+    perDetent = elapsed / detents;
+    interval = (interval * 3 + perDetent) / 4;
+
+    if (interval >= profile->slowInterval || profile->slowInterval <= profile->fastInterval || profile->maxMultiplier <= 1)
+        return delta;
+    if (interval <= profile->fastInterval)
+        t = 256;
+    else
+        t = (long)(profile->slowInterval - interval) * 256 / (profile->slowInterval - profile->fastInterval);
+    if (profile->curve == ACCELERATION_CURVE::QUADRATIC)
+        t = t * t / 256;
+    multiplier = 1 + (t * (profile->maxMultiplier - 1) + 128) / 256;
+    return delta * multiplier;
+}
@@ -0,0 +1,44 @@
+#ifndef MENU_ACCELERATION_H
+#define MENU_ACCELERATION_H
+
+#include <Arduino.h>
+
+enum ACCELERATION_CURVE
+{
+    LINEAR,
+    QUADRATIC
+};
+
+// Describes how a value item speeds up as the encoder is turned faster.  Profiles are
+// normally declared const (so they live in flash) and may be shared by any number of items.
+struct MenuAccelerationProfile
+{
+    uint16_t fastInterval;   // ms between detents at (or below) which maxMultiplier applies
+    uint16_t slowInterval;   // ms between detents at (or above) which there is no acceleration
+    uint16_t maxMultiplier;  // Largest number of steps applied per detent
+    uint16_t idleReset;      // ms without a detent, after which we start again from a multiplier of 1
+    ACCELERATION_CURVE curve;
+};
+
+// A reasonable starting point: up to 10 x step when spinning quickly
+extern const MenuAccelerationProfile menuDefaultAcceleration;
+
+// Timing engine shared by the numeric value items.  Only one item is ever being edited (in each
+// MenuContext, which has one of these), so a single instance tracks the inter-detent timing; it
+// restarts when a different item (or encoder) is turned, when the direction reverses, or after
+// idleReset ms.
+class MenuAccelerator
+{
+protected:
+    const void *owner = nullptr;
+    uint8_t source = 0;
+    unsigned long lastTime = 0; // micros() of the last detent
+    unsigned long interval = 0; // Smoothed ms per detent
+    bool clockwise = true;
+
+public:
+    long apply(const MenuAccelerationProfile *profile, const void *owner, uint8_t source, long delta, unsigned long time);
+    void reset();
+};
+
+#endif // MENU_ACCELERATION_H
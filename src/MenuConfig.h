@@ -0,0 +1,105 @@
+#ifndef MENU_CONFIG_H
+#define MENU_CONFIG_H
+
+// Build-time options.  Override these with compiler flags (e.g. PlatformIO's build_flags = -DMENU_SYSTEM_STATS=1)
+// so the library's own source files see the same values as your sketch.
+
+// Largest geometry an HD44780 controller can drive (80 characters of DDRAM)
+#ifndef MENU_SYSTEM_MAX_COLS
+#define MENU_SYSTEM_MAX_COLS 40
+#endif
+#ifndef MENU_SYSTEM_MAX_ROWS
+#define MENU_SYSTEM_MAX_ROWS 4
+#endif
+// Narrowest display the item layouts work on (selection marker, a few characters of label, type indicator)
+#ifndef MENU_SYSTEM_MIN_COLS
+#define MENU_SYSTEM_MIN_COLS 8
+#endif
+// Longest MenuLabel (and MENU_LIST entry) the compiler accepts - by default what fits between the
+// selection marker and the type indicator on a 16 column display.  Raise it (to no more than
+// MENU_SYSTEM_MAX_COLS - 2) if your menus are only ever shown on a wider one, e.g. 18 for 20 columns.
+#ifndef MENU_LABEL_WIDTH
+#define MENU_LABEL_WIDTH 14
+#endif
+// Longest MenuOption (a MenuBoolValue's two options share a row) - half the label width by default
+#ifndef MENU_OPTION_WIDTH
+#define MENU_OPTION_WIDTH (MENU_LABEL_WIDTH / 2)
+#endif
+
+// Number of encoder events which can be waiting for MenuSystem::poll() - must be a power of 2 (no more than 128)
+#ifndef MENU_SYSTEM_EVENT_QUEUE_SIZE
+#define MENU_SYSTEM_EVENT_QUEUE_SIZE 16
+#endif
+
+// Number of MenuContexts (independent menu sessions, each with its own display & encoders) which
+// can be begun, including the default one MenuSystem::begin() uses - no more than 4
+#ifndef MENU_SYSTEM_MAX_CONTEXTS
+#define MENU_SYSTEM_MAX_CONTEXTS 2
+#endif
+
+// Number of items a MenuContext remembers to return focus to (menus within menus, an action's own menu...)
+#ifndef MENU_SYSTEM_FOCUS_DEPTH
+#define MENU_SYSTEM_FOCUS_DEPTH 8
+#endif
+
+// Number of levels of the focus stack (from the bottom) whose screen is kept while an item above
+// has focus, so a Menu being returned to needn't be drawn again from scratch (0 = always redraw)
+#ifndef MENU_SYSTEM_SCREEN_CACHE_DEPTH
+#define MENU_SYSTEM_SCREEN_CACHE_DEPTH 4
+#endif
+
+// Number of value items which can be persisted (see persist() on the value items)
+#ifndef MENU_SYSTEM_MAX_SETTINGS
+#define MENU_SYSTEM_MAX_SETTINGS 16
+#endif
+
+// Number of entries from list text providers which are kept for redrawing (see MenuListSource)
+#ifndef MENU_SYSTEM_LIST_CACHE_SIZE
+#define MENU_SYSTEM_LIST_CACHE_SIZE 4
+#endif
+
+// Bytes of room for each item a MenuDynamic builds (enough for any of the library's item classes)
+#ifndef MENU_SYSTEM_DYNAMIC_ITEM_SIZE
+#define MENU_SYSTEM_DYNAMIC_ITEM_SIZE (32 * sizeof(void *))
+#endif
+
+// Default render limits (see MenuSystem::setRenderLimits()) - 0 = unlimited
+#ifndef MENU_SYSTEM_MAX_FPS
+#define MENU_SYSTEM_MAX_FPS 0
+#endif
+#ifndef MENU_SYSTEM_FRAME_BYTE_BUDGET
+#define MENU_SYSTEM_FRAME_BYTE_BUDGET 0
+#endif
+
+// 1 = MenuSystem::startRenderTask() is available (it needs FreeRTOS, so it's on by default for the ESP32 only)
+#ifndef MENU_SYSTEM_RENDER_TASK
+#if defined(ESP32)
+#define MENU_SYSTEM_RENDER_TASK 1
+#else
+#define MENU_SYSTEM_RENDER_TASK 0
+#endif
+#endif
+
+// 1 = collect redraw cost & input latency statistics (see MenuSystem::printStats()).
+// When 0, the statistics hooks compile to nothing.
+#ifndef MENU_SYSTEM_STATS
+#define MENU_SYSTEM_STATS 0
+#endif
+#if MENU_SYSTEM_STATS
+#define MENU_STAT(statement) statement
+#else
+#define MENU_STAT(statement)
+#endif
+
+// 1 = begin() writes the RAM each class of menu item takes to Serial (see MenuSystem::printFootprint())
+#ifndef MENU_SYSTEM_FOOTPRINT_REPORT
+#define MENU_SYSTEM_FOOTPRINT_REPORT 0
+#endif
+
+// Bytes of RAM a menu item may take, checked for each item class as the library is built (so on the
+// target's own sizes) - the build fails, naming the class, if one is bigger.  0 = no limit.
+#ifndef MENU_SYSTEM_MAX_ITEM_FOOTPRINT
+#define MENU_SYSTEM_MAX_ITEM_FOOTPRINT 0
+#endif
+
+#endif // MENU_CONFIG_H
@@ -0,0 +1,48 @@
+#include "MenuEventQueue.h"
+
+#define QUEUE_MASK (MENU_SYSTEM_EVENT_QUEUE_SIZE - 1)
+
+// Producer side - never blocks.  When the ring is full the event is dropped and counted.
+bool MenuEventQueue::push(uint8_t source, uint8_t event, unsigned long value)
+{
+    uint8_t h = head.load(std::memory_order_relaxed);
+    uint8_t t = tail.load(std::memory_order_acquire);
+    uint8_t used = (uint8_t)(h - t);
+
+    if (used >= MENU_SYSTEM_EVENT_QUEUE_SIZE)
+    {
+        overflows.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    events[h & QUEUE_MASK].source = source;
+    events[h & QUEUE_MASK].event = event;
+    events[h & QUEUE_MASK].value = value;
+    events[h & QUEUE_MASK].time = micros();
+    head.store((uint8_t)(h + 1), std::memory_order_release);
+    if (used + 1 > highWater)
+        highWater = used + 1;
+    return true;
+}
+
+// Consumer side
+bool MenuEventQueue::pop(MenuEvent &event)
+{
+    uint8_t t = tail.load(std::memory_order_relaxed);
+
+    if (t == head.load(std::memory_order_acquire))
+        return false;
+    event = events[t & QUEUE_MASK];
+    tail.store((uint8_t)(t + 1), std::memory_order_release);
+    return true;
+}
+
+int MenuEventQueue::depth()
+{
+    return (uint8_t)(head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire));
+}
+
+void MenuEventQueue::resetStats()
+{
+    overflows.store(0, std::memory_order_relaxed);
+    highWater = 0;
+}
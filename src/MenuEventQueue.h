@@ -0,0 +1,40 @@
+#ifndef MENU_EVENT_QUEUE_H
+#define MENU_EVENT_QUEUE_H
+
+#include <Arduino.h>
+#include <atomic>
+#include "MenuConfig.h"
+
+static_assert((MENU_SYSTEM_EVENT_QUEUE_SIZE & (MENU_SYSTEM_EVENT_QUEUE_SIZE - 1)) == 0 && MENU_SYSTEM_EVENT_QUEUE_SIZE <= 128,
+              "MENU_SYSTEM_EVENT_QUEUE_SIZE must be a power of 2, no greater than 128");
+
+struct MenuEvent
+{
+    uint8_t source;      // ENCODER_SOURCE
+    uint8_t event;       // ENCODER_EVENT
+    unsigned long value; // Turn direction (1 = clockwise) or press duration
+    unsigned long time;  // micros() when the encoder callback fired (for acceleration, and the latency statistics)
+};
+
+// Lock-free single-producer/single-consumer ring.  The encoder callbacks are the producer
+// (ESP32RotaryEncoder calls both encoders' callbacks from the same context) and
+// MenuSystem::poll() is the consumer.
+class MenuEventQueue
+{
+protected:
+    MenuEvent events[MENU_SYSTEM_EVENT_QUEUE_SIZE];
+    std::atomic<uint8_t> head{0}; // Next slot to write (only changed by the producer)
+    std::atomic<uint8_t> tail{0}; // Next slot to read (only changed by the consumer)
+    std::atomic<uint32_t> overflows{0};
+    uint8_t highWater = 0;
+
+public:
+    bool push(uint8_t source, uint8_t event, unsigned long value);
+    bool pop(MenuEvent &event);
+    int depth();
+    int maxDepth() { return highWater; }
+    unsigned long overflowCount() { return overflows.load(std::memory_order_relaxed); }
+    void resetStats();
+};
+
+#endif // MENU_EVENT_QUEUE_H
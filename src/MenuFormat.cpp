@@ -0,0 +1,96 @@
+#include "MenuFormat.h"
+
+// Move to a column (anything already written there is overwritten by what follows)
+MenuFormatter &MenuFormatter::at(int col)
+{
+    column = col;
+    return *this;
+}
+
+MenuFormatter &MenuFormatter::put(char c)
+{
+    if (column >= 0 && column < width)
+        out[column] = c;
+    column++;
+    return *this;
+}
+
+// Fill with c up to (but not including) col
+MenuFormatter &MenuFormatter::padTo(int col, char c)
+{
+    while (column < col)
+        put(c);
+    return *this;
+}
+
+// Up to length characters (or to the end of the string if length is -ve)
+MenuFormatter &MenuFormatter::text(const char *text, int length)
+{
+    if (text)
+        for (; *text && length && column < width; text++, length--)
+            put(*text);
+    return *this;
+}
+
+// Exactly fieldWidth cells: the text clipped or space-padded to fit
+MenuFormatter &MenuFormatter::field(const char *text, int length, int fieldWidth)
+{
+    int end = column + fieldWidth;
+
+    if (length < 0 || length > fieldWidth)
+        length = fieldWidth;
+    this->text(text, length);
+    return padTo(end);
+}
+
+// The decimal digits of an unsigned value (any long's magnitude fits, LONG_MIN's included)
+MenuFormatter &MenuFormatter::digits(unsigned long magnitude)
+{
+    char digits[3 * sizeof(unsigned long)]; // At least one digit for every 8 bits
+    int count = 0;
+
+    do
+    {
+        digits[count++] = '0' + magnitude % 10;
+        magnitude /= 10;
+    } while (magnitude);
+    while (count)
+        put(digits[--count]);
+    return *this;
+}
+
+MenuFormatter &MenuFormatter::number(long value)
+{
+    unsigned long magnitude = value < 0 ? 0UL - (unsigned long)value : (unsigned long)value;
+
+    if (value < 0)
+        put('-');
+    return digits(magnitude);
+}
+
+// A scaled integer shown with a fixed number of decimal places, e.g. fixed(355, 3) -> "0.355"
+MenuFormatter &MenuFormatter::fixed(long scaled, uint8_t decimals)
+{
+    unsigned long magnitude = scaled < 0 ? 0UL - (unsigned long)scaled : (unsigned long)scaled;
+    unsigned long divisor = 1;
+    unsigned long fraction;
+
+    for (uint8_t i = 0; i < decimals; i++)
+        divisor *= 10;
+    if (scaled < 0)
+        put('-');
+    digits(magnitude / divisor);
+    if (!decimals)
+        return *this;
+    put('.');
+    fraction = magnitude % divisor;
+    while (divisor /= 10)
+        put('0' + (fraction / divisor) % 10);
+    return *this;
+}
+
+// A space, then the units (the space is written even with no units, so values line up)
+MenuFormatter &MenuFormatter::units(const MenuTextView &units)
+{
+    return put(' ').text(units);
+}
@@ -0,0 +1,38 @@
+#ifndef MENU_FORMAT_H
+#define MENU_FORMAT_H
+
+#include <Arduino.h>
+#include "MenuTree.h"
+
+// Fixed-width formatting straight into a row of cells (normally a row of the MenuFrameBuffer),
+// used by the menu items instead of sprintf - no temporary buffers, no format string parsing
+// and no float printf.  Everything written is clipped at the end of the row, and each call
+// returns the formatter so calls can be chained:
+//
+//     frame.row(1).number(*value).units(units).padTo(15).put(symbol('\001'));
+class MenuFormatter
+{
+protected:
+    char *out;
+    int width;
+    int column = 0;
+
+    MenuFormatter &digits(unsigned long magnitude);
+
+public:
+    MenuFormatter(char *out, int width) : out(out), width(out ? width : 0) {}
+
+    int col() { return column; }
+    MenuFormatter &at(int col);
+    MenuFormatter &put(char c);
+    MenuFormatter &padTo(int col, char c = ' ');
+    MenuFormatter &text(const char *text, int length = -1);
+    MenuFormatter &text(const MenuTextView &text) { return this->text(text.text, text.length); }
+    MenuFormatter &field(const char *text, int length, int fieldWidth);
+    MenuFormatter &field(const MenuTextView &text, int fieldWidth) { return field(text.text, text.length, fieldWidth); }
+    MenuFormatter &number(long value);
+    MenuFormatter &fixed(long scaled, uint8_t decimals);
+    MenuFormatter &units(const MenuTextView &units);
+};
+
+#endif // MENU_FORMAT_H
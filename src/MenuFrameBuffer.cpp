@@ -0,0 +1,167 @@
+#include "MenuFrameBuffer.h"
+
+void MenuFrameBuffer::begin(int width, int height)
+{
+    this->width = constrain(width, 0, MENU_SYSTEM_MAX_COLS);
+    this->height = constrain(height, 0, MENU_SYSTEM_MAX_ROWS);
+    clear();
+    invalidate();
+}
+
+// Blank the frame being built (nothing is sent to the LCD until flush())
+void MenuFrameBuffer::clear()
+{
+    memset(next, ' ', sizeof(next));
+    MENU_STAT(memset(drawnBy, pen, sizeof(drawnBy)));
+}
+
+void MenuFrameBuffer::restore(const MenuScreen &screen)
+{
+    memcpy(next, screen, sizeof(next));
+    MENU_STAT(memset(drawnBy, pen, sizeof(drawnBy)));
+}
+
+// Call after the LCD has been cleared in hardware, so we know every cell is now a space
+void MenuFrameBuffer::markCleared()
+{
+    memset(shown, ' ', sizeof(shown));
+    memset(unknown, 0, sizeof(unknown));
+    cursorCol = 0;
+    cursorRow = 0;
+}
+
+// Call when something other than the menu system has written to the LCD
+void MenuFrameBuffer::invalidate()
+{
+    for (int row = 0; row < MENU_SYSTEM_MAX_ROWS; row++)
+        unknown[row] = row < height && width ? ((uint64_t)2 << (width - 1)) - 1 : 0;
+    cursorCol = -1;
+    cursorRow = -1;
+}
+
+void MenuFrameBuffer::put(int col, int row, char c)
+{
+    if (col >= 0 && col < width && row >= 0 && row < height)
+    {
+        next[row][col] = c;
+        MENU_STAT(drawnBy[row] = pen);
+    }
+}
+
+// Text is clipped at the right hand edge of the display (and, optionally, to length characters)
+void MenuFrameBuffer::print(int col, int row, const char *text, int length)
+{
+    if (!text || row < 0 || row >= height)
+        return;
+    MENU_STAT(drawnBy[row] = pen);
+    for (; *text && length && col < width; col++, text++, length--)
+        if (col >= 0)
+            next[row][col] = *text;
+}
+
+// Format text straight into a row of the frame (see MenuFormatter)
+MenuFormatter MenuFrameBuffer::row(int row)
+{
+    if (row < 0 || row >= height)
+        return MenuFormatter(nullptr, 0);
+    MENU_STAT(drawnBy[row] = pen);
+    return MenuFormatter(next[row], width);
+}
+
+bool MenuFrameBuffer::dirty()
+{
+    for (int row = 0; row < height; row++)
+        if (unknown[row] || memcmp(next[row], shown[row], width))
+            return true;
+    return false;
+}
+
+// True if c is on the LCD, or waiting to be
+bool MenuFrameBuffer::uses(char c)
+{
+    for (int row = 0; row < height; row++)
+        if (memchr(next[row], c, width) || memchr(shown[row], c, width))
+            return true;
+    return false;
+}
+
+// Send changed cells to the LCD.  With a byteBudget (in bus bytes, as estimated by the transport),
+// stop once it's used up and leave the rest of the changes for the next flush, which carries on
+// from the row we stopped in - though unless spent (bytes of the budget already used, e.g. by custom
+// characters) says something's gone out already, we always send at least one, so we can't stall.
+// Returns the number of characters written (and, optionally, the number of cursor moves needed
+// to write them - and, with MENU_SYSTEM_STATS, the characters & bus bytes sent of each row).
+int MenuFrameBuffer::flush(MenuDisplayTransport *lcd, int *cursorMoves, unsigned int byteBudget, unsigned int spent)
+{
+    bool progress = spent > 0;
+    int written = 0;
+    int moves = 0;
+    int i, row, col, end;
+
+    if (cursorMoves)
+        *cursorMoves = 0;
+#if MENU_SYSTEM_STATS
+    memset(rowCells, 0, sizeof(rowCells));
+    memset(rowBytes, 0, sizeof(rowBytes));
+#endif
+    if (!lcd)
+        return 0;
+
+    for (i = 0; i < height; i++)
+    {
+        row = (firstRow + i) % height;
+        col = 0;
+        while (col < width)
+        {
+            if (!changed(row, col))
+            {
+                col++;
+                continue;
+            }
+            // Start of a run of changed cells - only move the cursor if it isn't already here
+            bool move = col != cursorCol || row != cursorRow;
+
+            for (end = col; end < width && changed(row, end); end++)
+                ;
+            if (byteBudget)
+            {
+                unsigned int cost = move ? lcd->cursorBytes() : 0;
+
+                // Send as much of the run as there's budget for
+                while (end - col > 1 && spent + cost + lcd->runBytes(end - col) > byteBudget)
+                    end--;
+                if ((written || progress) && spent + cost + lcd->runBytes(end - col) > byteBudget)
+                {
+                    firstRow = row;
+                    goto done;
+                }
+                spent += cost + lcd->runBytes(end - col);
+            }
+#if MENU_SYSTEM_STATS
+            unsigned long busBytes = lcd->busBytes;
+#endif
+            if (move)
+            {
+                lcd->setCursor(col, row);
+                moves++;
+            }
+            memcpy(&shown[row][col], &next[row][col], end - col);
+            unknown[row] &= ~(((uint64_t)2 << (end - 1)) - ((uint64_t)1 << col));
+            lcd->write((const uint8_t *)&next[row][col], end - col);
+            written += end - col;
+#if MENU_SYSTEM_STATS
+            rowCells[row] += end - col;
+            rowBytes[row] += lcd->busBytes - busBytes;
+#endif
+            col = end;
+            // The HD44780 address counter doesn't wrap onto the next visible row
+            cursorCol = col < width ? col : -1;
+            cursorRow = col < width ? row : -1;
+        }
+    }
+    firstRow = 0;
+done:
+    if (cursorMoves)
+        *cursorMoves = moves;
+    return written;
+}
@@ -0,0 +1,57 @@
+#ifndef MENU_FRAME_BUFFER_H
+#define MENU_FRAME_BUFFER_H
+
+#include <Arduino.h>
+#include "MenuConfig.h"
+#include "MenuTransport.h"
+#include "MenuFormat.h"
+
+static_assert(MENU_SYSTEM_MAX_COLS <= 64, "MenuFrameBuffer tracks each row's columns in 64 bits");
+
+// A copy of a whole frame (see MenuFrameBuffer::save())
+typedef char MenuScreen[MENU_SYSTEM_MAX_ROWS][MENU_SYSTEM_MAX_COLS];
+
+// In-RAM copy of the display.  Menu items render into the 'next' frame and flush() sends
+// only the cells which differ from what the LCD is already showing, with cursor moves
+// coalesced into contiguous runs, each sent with a single write (each character costs several
+// I2C transactions on a PCF8574 backpack, so re-printing unchanged cells is expensive).
+class MenuFrameBuffer
+{
+protected:
+    MenuScreen next;  // What we want on the LCD
+    MenuScreen shown; // What the LCD is currently showing
+    int width = 0;
+    int height = 0;
+    int cursorCol = -1; // Where the LCD's address counter is (-1 = unknown)
+    int cursorRow = -1;
+    uint64_t unknown[MENU_SYSTEM_MAX_ROWS]; // Cells whose LCD contents we don't know (bit per column) - always sent
+    int firstRow = 0;                       // Where the next flush starts (so rows left over by a budget get their turn)
+
+    bool changed(int row, int col) { return (unknown[row] >> col & 1) || next[row][col] != shown[row][col]; }
+
+public:
+#if MENU_SYSTEM_STATS
+    // Who is drawing (a MENU_ITEM_TYPE): each row remembers the last pen it was drawn with, and flush()
+    // what it sent of each row, so the cost can be put down to the class which drew it
+    uint8_t pen = 0;
+    uint8_t drawnBy[MENU_SYSTEM_MAX_ROWS] = {};
+    unsigned int rowCells[MENU_SYSTEM_MAX_ROWS] = {};
+    unsigned long rowBytes[MENU_SYSTEM_MAX_ROWS] = {};
+#endif
+
+    void begin(int width, int height);
+    void clear();
+    void markCleared();
+    void invalidate();
+    void forgetCursor() { cursorCol = cursorRow = -1; }
+    bool uses(char c);
+    void save(MenuScreen &screen) const { memcpy(screen, next, sizeof(next)); }
+    void restore(const MenuScreen &screen); // (Only the differences from what's shown are sent, as ever)
+    void put(int col, int row, char c);
+    void print(int col, int row, const char *text, int length = -1);
+    MenuFormatter row(int row);
+    bool dirty();
+    int flush(MenuDisplayTransport *lcd, int *cursorMoves = nullptr, unsigned int byteBudget = 0, unsigned int spent = 0);
+};
+
+#endif // MENU_FRAME_BUFFER_H
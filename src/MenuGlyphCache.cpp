@@ -0,0 +1,82 @@
+#include "MenuGlyphCache.h"
+
+// Forget what's in CGRAM (every slot is free again)
+void MenuGlyphCache::begin()
+{
+    memset(lastUsed, 0, sizeof(lastUsed));
+    waiting = 0;
+    requests = 0;
+}
+
+// Returns the slot holding bitmap - giving it one first (the preferred slot, if that's free) if need
+// be, for upload() to send - or -1 if every slot holds a glyph which is on the display
+int MenuGlyphCache::slotFor(const uint8_t bitmap[8], int preferred, MenuFrameBuffer &frame, MenuDisplayTransport *lcd)
+{
+    int slot = -1;
+
+    requests++;
+    for (int i = 0; i < MENU_GLYPH_SLOTS; i++)
+        if (lastUsed[i] && !memcmp(bitmaps[i], bitmap, 8))
+        {
+            lastUsed[i] = requests;
+            return i;
+        }
+    if (!lcd)
+        return -1;
+
+    if (preferred >= 0 && preferred < MENU_GLYPH_SLOTS && !lastUsed[preferred])
+        slot = preferred;
+    // Free slots from 1 up (slot 0 last, as '\0' is awkward to put in a string)...
+    for (int i = 1; slot < 0 && i <= MENU_GLYPH_SLOTS; i++)
+        if (!lastUsed[i % MENU_GLYPH_SLOTS])
+            slot = i % MENU_GLYPH_SLOTS;
+    if (slot < 0)
+    {
+        // ...then the least recently requested glyph which isn't on the display
+        for (int i = 0; i < MENU_GLYPH_SLOTS; i++)
+            if (!frame.uses(i) && !frame.uses(i + 8) && (slot < 0 || lastUsed[i] < lastUsed[slot]))
+                slot = i;
+        if (slot < 0)
+            return -1;
+        evictionCount++;
+    }
+
+    memcpy(bitmaps[slot], bitmap, 8);
+    lastUsed[slot] = requests;
+    waiting |= 1 << slot;
+    return slot;
+}
+
+// Send the glyphs given slots since the last upload to the LCD, as long as they fit in byteBudget bus
+// bytes (0 = no limit - though at least one is always sent, so they can't stall), adding what they
+// cost (as estimated by the transport) to spent.  Returns the number sent.
+int MenuGlyphCache::upload(MenuDisplayTransport *lcd, MenuFrameBuffer &frame, unsigned int byteBudget, unsigned int &spent)
+{
+    int sent = 0;
+
+    if (!lcd)
+        return 0;
+    for (int slot = 0; waiting && slot < MENU_GLYPH_SLOTS; slot++)
+    {
+        unsigned int cost = lcd->cursorBytes() + lcd->runBytes(8); // Set the CGRAM address, then the 8 rows
+
+        if (!(waiting >> slot & 1))
+            continue;
+        if (byteBudget && sent && spent + cost > byteBudget)
+            break;
+        lcd->createChar(slot, bitmaps[slot]);
+        waiting &= ~(1 << slot);
+        spent += cost;
+        sent++;
+        loadCount++;
+    }
+    if (sent)
+        frame.forgetCursor(); // The LCD's address counter is now in CGRAM
+    return sent;
+}
+
+void MenuGlyphCache::resetStats()
+{
+    loadCount = 0;
+    evictionCount = 0;
+}
@@ -0,0 +1,38 @@
+#ifndef MENU_GLYPH_CACHE_H
+#define MENU_GLYPH_CACHE_H
+
+#include <Arduino.h>
+#include "MenuTransport.h"
+#include "MenuFrameBuffer.h"
+
+#define MENU_GLYPH_SLOTS 8 // HD44780 CGRAM holds 8 custom characters
+
+// Hands out the LCD's custom character slots by glyph (the 8 bytes of the bitmap, not where it's
+// stored), to the menu system and the sketch alike.  A glyph which is already loaded is reused;
+// otherwise it goes into a free slot or, failing that, the least recently requested one which
+// isn't on the display (or waiting to be), so 8 bytes are only sent when they have to be - and then
+// by upload(), with the frame, so they count against its byte budget.
+class MenuGlyphCache
+{
+protected:
+    uint8_t bitmaps[MENU_GLYPH_SLOTS][8];
+    unsigned long lastUsed[MENU_GLYPH_SLOTS]; // When each slot was last requested (0 = empty)
+    uint8_t waiting = 0;                      // Slots whose glyph is still to be sent to the LCD (bit per slot)
+    unsigned long requests = 0;
+    unsigned long loadCount = 0;
+    unsigned long evictionCount = 0;
+
+public:
+    void begin();
+    int slotFor(const uint8_t bitmap[8], int preferred, MenuFrameBuffer &frame, MenuDisplayTransport *lcd);
+    int upload(MenuDisplayTransport *lcd, MenuFrameBuffer &frame, unsigned int byteBudget, unsigned int &spent);
+    bool pending() { return waiting; }
+    unsigned long loads() { return loadCount; }
+    unsigned long evictions() { return evictionCount; }
+    void resetStats();
+
+    // The character which displays a slot (slot 0 is also character 8, which won't end a string)
+    static char code(int slot) { return slot ? (char)slot : '\010'; }
+};
+
+#endif // MENU_GLYPH_CACHE_H
@@ -0,0 +1,54 @@
+#include "MenuList.h"
+
+int MenuListSource::count() const
+{
+    return countProvider ? max(countProvider(), 0) : itemCount;
+}
+
+// The text of entry index ("" if there's no such entry), from the provider only if it isn't cached.
+// The pointer is good until the next call.
+const char *MenuListCache::text(const void *owner, const MenuListSource &list, int index)
+{
+    if (index < 0 || index >= list.count())
+        return "";
+    if (!list.textProvider)
+        return list.items[index] ? list.items[index] : "";
+
+    Entry *entry = &entries[0];
+    uses++;
+    for (int i = 0; i < MENU_SYSTEM_LIST_CACHE_SIZE; i++)
+    {
+        if (entries[i].lastUsed && entries[i].owner == owner && entries[i].index == index)
+        {
+            hitCount++;
+            entries[i].lastUsed = uses;
+            return entries[i].text;
+        }
+        if (entries[i].lastUsed < entry->lastUsed)
+            entry = &entries[i];
+    }
+
+    // Not cached - ask for it, in place of the least recently used entry
+    fetchCount++;
+    entry->owner = owner;
+    entry->index = index;
+    entry->lastUsed = uses;
+    entry->text[0] = 0;
+    list.textProvider(index, entry->text, sizeof(entry->text));
+    entry->text[sizeof(entry->text) - 1] = 0;
+    return entry->text;
+}
+
+// Drop owner's entries (its list has changed)
+void MenuListCache::forget(const void *owner)
+{
+    for (int i = 0; i < MENU_SYSTEM_LIST_CACHE_SIZE; i++)
+        if (entries[i].owner == owner)
+            entries[i].lastUsed = 0;
+}
+
+void MenuListCache::resetStats()
+{
+    fetchCount = 0;
+    hitCount = 0;
+}
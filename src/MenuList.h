@@ -0,0 +1,58 @@
+#ifndef MENU_LIST_H
+#define MENU_LIST_H
+
+#include <Arduino.h>
+#include "MenuConfig.h"
+#include "MenuTree.h"
+
+// Providers for a list whose entries are worked out as they're needed (see MenuListSource)
+typedef int (*list_count_t)();
+typedef void (*list_text_t)(int index, char *text, size_t size); // Write entry index into text (size includes the terminator)
+
+// The entries of a list value item (MenuDropDownListValue & MenuRotaryListValue): either a list of
+// strings, or a count and a text provider - for lists which are long (e.g. a table of wire gauges),
+// or change at run time (e.g. stored recipes).  A provider is only asked for the entries which
+// are drawn, so nothing is held for the rest of the list.
+struct MenuListSource
+{
+    const char *const *items;
+    int itemCount;
+    list_count_t countProvider;
+    list_text_t textProvider;
+
+    constexpr MenuListSource(const char *const *items = nullptr, int itemCount = 0)
+        : items(items), itemCount(itemCount), countProvider(nullptr), textProvider(nullptr) {}
+    constexpr MenuListSource(const MenuStringList &list)
+        : items(list.items), itemCount(list.count), countProvider(nullptr), textProvider(nullptr) {}
+    constexpr MenuListSource(list_count_t countProvider, list_text_t textProvider)
+        : items(nullptr), itemCount(0), countProvider(countProvider), textProvider(textProvider) {}
+    int count() const;
+};
+
+// The text of the provider-backed list entries drawn most recently, shared by all the list items -
+// so redrawing an entry (e.g. as the menu scrolls back over it) doesn't ask for it again, and the
+// RAM used is the same however long the lists are.
+class MenuListCache
+{
+protected:
+    struct Entry
+    {
+        const void *owner;
+        int index;
+        unsigned long lastUsed; // (0 = empty)
+        char text[MENU_SYSTEM_MAX_COLS + 1];
+    };
+    Entry entries[MENU_SYSTEM_LIST_CACHE_SIZE] = {};
+    unsigned long uses = 0;
+    unsigned long fetchCount = 0;
+    unsigned long hitCount = 0;
+
+public:
+    const char *text(const void *owner, const MenuListSource &list, int index);
+    void forget(const void *owner);
+    unsigned long fetches() { return fetchCount; }
+    unsigned long hits() { return hitCount; }
+    void resetStats();
+};
+
+#endif // MENU_LIST_H
@@ -0,0 +1,90 @@
+#include "MenuNotify.h"
+
+// minInterval = the fewest ms between calls (0 = at most once per poll())
+void MenuValueNotifier::onChange(value_callback_t callback, uint16_t minInterval)
+{
+    changeCallback = callback;
+    this->minInterval = minInterval;
+    lastChange = millis() - minInterval; // The first change needn't wait
+}
+
+void MenuValueNotifier::onCommit(value_callback_t callback)
+{
+    commitCallback = callback;
+}
+
+// Called by the item as its editor takes focus (value is the variable being edited - up to 8 bytes)
+void MenuValueNotifier::editing(MenuValueChanges &changes, MenuSystem *item, const void *value, size_t size)
+{
+    this->item = item;
+    changes.editor = this;
+    changes.value = value;
+    changes.size = min(size, sizeof(changes.original));
+    if (value)
+    {
+        memcpy(changes.original, value, changes.size);
+        memcpy(changes.latest, value, changes.size);
+    }
+}
+
+// Called by the item after anything which may have changed the value
+void MenuValueNotifier::update(MenuValueChanges &changes)
+{
+    if (changes.editor != this || !changes.value || !memcmp(changes.latest, changes.value, changes.size))
+        return;
+    memcpy(changes.latest, changes.value, changes.size);
+    if (changeCallback && !pending)
+    {
+        pending = true;
+        nextPending = changes.pendingList;
+        changes.pendingList = this;
+    }
+}
+
+// Called by the item as its editor returns focus
+void MenuValueNotifier::commit(MenuValueChanges &changes)
+{
+    update(changes);
+    if (pending)
+    {
+        // Deliver the last change now, so it can't arrive after the commit
+        for (MenuValueNotifier **link = &changes.pendingList; *link; link = &(*link)->nextPending)
+            if (*link == this)
+            {
+                *link = nextPending;
+                break;
+            }
+        deliverChange();
+    }
+    if (changes.editor != this)
+        return;
+    if (commitCallback && changes.value && memcmp(changes.original, changes.latest, changes.size))
+        commitCallback(item);
+    memcpy(changes.original, changes.latest, changes.size);
+}
+
+void MenuValueNotifier::deliverChange()
+{
+    pending = false;
+    nextPending = nullptr;
+    lastChange = millis();
+    changeCallback(item);
+}
+
+// Called by poll(), once all the queued input has been handled: makes the onChange() calls which are due
+void MenuValueNotifier::deliver(MenuValueChanges &changes)
+{
+    MenuValueNotifier **link = &changes.pendingList;
+
+    while (*link)
+    {
+        MenuValueNotifier *notifier = *link;
+        if (!notifier->minInterval || millis() - notifier->lastChange >= notifier->minInterval)
+        {
+            *link = notifier->nextPending;
+            notifier->deliverChange(); // (It may change other values, adding them to the list)
+        }
+        else
+            link = &notifier->nextPending;
+    }
+}
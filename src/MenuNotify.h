@@ -0,0 +1,54 @@
+#ifndef MENU_NOTIFY_H
+#define MENU_NOTIFY_H
+
+#include <Arduino.h>
+
+class MenuSystem;
+
+// Called with the item whose value changed (see onChange() & onCommit() on the value items)
+typedef void (*value_callback_t)(MenuSystem *item);
+
+class MenuValueNotifier;
+
+// A MenuContext's value changes: the onChange() calls waiting for poll(), and the value its editor
+// is changing - as it was when editing started, and when we last looked.  Only one item edits at
+// a time in a context, so this is kept once by the context, rather than by every value item.
+struct MenuValueChanges
+{
+    MenuValueNotifier *pendingList = nullptr;
+    const MenuValueNotifier *editor = nullptr; // (The notifier of the item editing value)
+    const void *value = nullptr;
+    uint8_t size = 0;
+    uint8_t original[8] = {}; // The value when editing started
+    uint8_t latest[8] = {};   // ...and when we last looked
+};
+
+// Tells the sketch when a value item's value changes, so it needn't keep checking the variable.
+// Changes are only noted here as they're made; poll() delivers them once it has handled all of
+// the queued input (so a fast spin is one onChange(), with the final value), no more often than
+// every minInterval ms.  onCommit() is called when the editor returns focus - but only if the
+// value it leaves is different from the one it started with.  The values being edited, and the
+// changes waiting for poll(), are kept by each MenuContext (in its MenuValueChanges).
+class MenuValueNotifier
+{
+protected:
+    value_callback_t changeCallback = nullptr;
+    value_callback_t commitCallback = nullptr;
+    MenuSystem *item = nullptr;
+    MenuValueNotifier *nextPending = nullptr;
+    unsigned long lastChange = 0; // millis() of the last onChange()
+    uint16_t minInterval = 0;
+    bool pending = false;
+
+    void deliverChange();
+
+public:
+    void onChange(value_callback_t callback, uint16_t minInterval);
+    void onCommit(value_callback_t callback);
+    void editing(MenuValueChanges &changes, MenuSystem *item, const void *value, size_t size);
+    void update(MenuValueChanges &changes);
+    void commit(MenuValueChanges &changes);
+    static void deliver(MenuValueChanges &changes);
+};
+
+#endif // MENU_NOTIFY_H
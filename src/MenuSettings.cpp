@@ -0,0 +1,275 @@
+#include "MenuSettings.h"
+#include "DualEncoderMenuSystem.h"
+
+#define SETTINGS_MAGIC 0x31554E4DUL // "MNU1"
+#define SECTOR_HEADER_SIZE 8        // Magic & sequence number
+#define RECORD_HEADER_SIZE 4        // Key (2 bytes), size & checksum
+#define MAX_RECORD_SIZE (RECORD_HEADER_SIZE + 8)
+
+// Records are padded to 4 bytes, so each one starts word aligned.  (Writes needn't be whole words:
+// a record's checksum byte is written on its own - see writeRecord() - which the ESP32's flash
+// allows as long as flash encryption, which writes 16-byte blocks, is off.)
+static size_t recordSize(uint8_t size) { return RECORD_HEADER_SIZE + ((size + 3) & ~3); }
+
+// CRC-8 of the record (but never 0xFF, which marks a record whose write didn't finish)
+static uint8_t checksum(const uint8_t *record)
+{
+    uint8_t crc = 0;
+
+    for (size_t i = 0; i < RECORD_HEADER_SIZE + (size_t)record[2]; i++)
+    {
+        if (i == 3)
+            continue;
+        crc ^= record[i];
+        for (int bit = 0; bit < 8; bit++)
+            crc = crc & 0x80 ? (uint8_t)(crc << 1 ^ 0x07) : (uint8_t)(crc << 1);
+    }
+    return crc == 0xFF ? 0x7F : crc;
+}
+
+// Persist value (size bytes) under key - 0 to 0xFFFE, and not to be reused for anything else
+// once it's been stored.  Returns false if the table (MENU_SYSTEM_MAX_SETTINGS) is full.
+bool MenuSettings::add(uint16_t key, MenuSystem *item, void *value, size_t size)
+{
+    if (!value || size > sizeof(settings[0].saved) || key == 0xFFFF || count >= MENU_SYSTEM_MAX_SETTINGS)
+        return false;
+    for (int i = 0; i < count; i++)
+        if (settings[i].key == key)
+            return false;
+
+    MenuSetting &setting = settings[count++];
+    setting.key = key;
+    setting.size = (uint8_t)size;
+    setting.item = item;
+    setting.value = value;
+    memcpy(setting.saved, value, size);
+    return true;
+}
+
+// Find the newest sector & restore every persisted value from it.  Values with nothing stored
+// keep what they were given, and nothing is written until one of them changes.
+bool MenuSettings::begin(MenuStorage *storage, uint32_t commitDelay)
+{
+    this->commitDelay = commitDelay;
+    this->storage = nullptr;
+    sector = -1;
+    writeOffset = 0;
+    dirty = false;
+    if (!storage || !storage->begin() || storage->sectorCount() < 2 || storage->sectorSize() < SECTOR_HEADER_SIZE + MAX_RECORD_SIZE)
+        return false; // (With one sector, a power cut while it was being rewritten would lose everything)
+    this->storage = storage;
+
+    size_t size = storage->sectorSize();
+    for (int i = 0; i < storage->sectorCount(); i++)
+    {
+        uint32_t header[2];
+        if (storage->read(i * size, header, sizeof(header)) && header[0] == SETTINGS_MAGIC &&
+            (sector < 0 || (int32_t)(header[1] - sequence) > 0))
+        {
+            sector = i;
+            sequence = header[1];
+        }
+    }
+    for (int i = 0; i < count; i++)
+        memcpy(settings[i].saved, settings[i].value, settings[i].size);
+    if (sector < 0)
+        return true; // Nothing stored yet
+
+    // One pass through the records, a buffer at a time
+    uint8_t buffer[64];
+    size_t base = sector * size;
+    size_t offset = SECTOR_HEADER_SIZE;
+    size_t bufferStart = offset;
+    size_t bufferEnd = offset;
+    bool damaged = false;
+
+    while (offset + RECORD_HEADER_SIZE <= size)
+    {
+        if (offset + MAX_RECORD_SIZE > bufferEnd && bufferEnd < size)
+        {
+            bufferStart = offset;
+            bufferEnd = offset + min(sizeof(buffer), size - offset);
+            if (!storage->read(base + bufferStart, buffer, bufferEnd - bufferStart))
+            {
+                damaged = true;
+                break;
+            }
+        }
+        const uint8_t *record = buffer + (offset - bufferStart);
+        size_t erased = 0;
+        while (erased < MAX_RECORD_SIZE && offset + erased < bufferEnd && record[erased] == 0xFF)
+            erased++;
+        if (erased >= RECORD_HEADER_SIZE && (erased == MAX_RECORD_SIZE || offset + erased == bufferEnd))
+            break; // The end of the log
+        if (erased >= RECORD_HEADER_SIZE || record[2] > 8 || recordSize(record[2]) > bufferEnd - offset || checksum(record) != record[3])
+        {
+            damaged = true; // The power went as it was being written
+            break;
+        }
+        uint16_t key = record[0] | record[1] << 8;
+        for (int i = 0; i < count; i++)
+            if (settings[i].key == key && settings[i].size == record[2])
+                memcpy(settings[i].saved, record + RECORD_HEADER_SIZE, record[2]);
+        offset += recordSize(record[2]);
+    }
+    // Don't write over a damaged record - the next commit starts a fresh sector instead
+    writeOffset = damaged ? size : offset;
+
+    for (int i = 0; i < count; i++)
+        if (memcmp(settings[i].value, settings[i].saved, settings[i].size))
+        {
+            memcpy(settings[i].value, settings[i].saved, settings[i].size);
+            if (settings[i].item)
+                settings[i].item->restored();
+        }
+    return true;
+}
+
+// Called by poll() with the item which has focus: commits the changes once their editor has
+// returned focus, or when the oldest one has waited commitDelay ms
+void MenuSettings::service(const MenuSystem *focus)
+{
+    bool editing = false;
+
+    if (!storage)
+        return;
+    for (int i = 0; i < count; i++)
+    {
+        if (settings[i].item && settings[i].item == focus)
+            editing = true;
+        if (!dirty && memcmp(settings[i].value, settings[i].saved, settings[i].size))
+        {
+            dirty = true;
+            dirtySince = millis();
+        }
+    }
+    if (dirty && ((wasEditing && !editing) || millis() - dirtySince >= commitDelay))
+        commit();
+    wasEditing = editing;
+}
+
+// Write every value which differs from the stored one.  Returns false if it couldn't be written
+// (it's tried again after another commitDelay).
+bool MenuSettings::commit()
+{
+    bool written = true;
+    bool changed = false;
+
+    if (!storage)
+        return false;
+    for (int i = 0; i < count && written; i++)
+        if (memcmp(settings[i].value, settings[i].saved, settings[i].size))
+        {
+            changed = true;
+            if (!append(settings[i]))
+                written = compact(); // The sector's full: move everything on to the next one
+        }
+    if (changed)
+        commitCount++;
+    dirty = !written;
+    dirtySince = millis();
+    return written;
+}
+
+// Write a record of setting's current value at offset - returns its size, or 0 if that failed
+size_t MenuSettings::writeRecord(MenuSetting &setting, size_t offset)
+{
+    uint8_t record[MAX_RECORD_SIZE];
+    size_t length = recordSize(setting.size);
+
+    memset(record, 0xFF, sizeof(record)); // (Padding is left erased)
+    record[0] = setting.key & 0xFF;
+    record[1] = setting.key >> 8;
+    record[2] = setting.size;
+    memcpy(record + RECORD_HEADER_SIZE, setting.value, setting.size);
+    // The checksum goes on last, so a record the power went in the middle of is always missing it
+    if (!storage->write(offset, record, length))
+        return 0;
+    record[3] = checksum(record);
+    if (!storage->write(offset + 3, record + 3, 1))
+        return 0;
+    recordCount++;
+    return length;
+}
+
+// Add a record to the active sector, if there's room
+bool MenuSettings::append(MenuSetting &setting)
+{
+    size_t length = 0;
+
+    if (sector >= 0 && writeOffset + recordSize(setting.size) <= storage->sectorSize())
+        length = writeRecord(setting, sector * storage->sectorSize() + writeOffset);
+    if (!length)
+        return false;
+    writeOffset += length;
+    memcpy(setting.saved, setting.value, setting.size);
+    return true;
+}
+
+// Erase the next sector & write all the current values to it.  Its header goes on last, so until
+// then (should the power go) the old sector is still the one which is restored.
+bool MenuSettings::compact()
+{
+    size_t size = storage->sectorSize();
+    int next = (sector + 1) % storage->sectorCount();
+    size_t offset = SECTOR_HEADER_SIZE;
+    uint32_t header[2] = {SETTINGS_MAGIC, sequence + 1};
+
+    if (!storage->erase(next))
+        return false;
+    eraseCount++;
+    for (int i = 0; i < count; i++)
+    {
+        size_t length = offset + recordSize(settings[i].size) <= size ? writeRecord(settings[i], next * size + offset) : 0;
+        if (!length)
+            return false;
+        offset += length;
+    }
+    // (The sequence number before the magic number, so a sector with one has the other)
+    if (!storage->write(next * size + 4, &header[1], 4) || !storage->write(next * size, &header[0], 4))
+        return false;
+    for (int i = 0; i < count; i++)
+        memcpy(settings[i].saved, settings[i].value, settings[i].size);
+    sector = next;
+    sequence++;
+    writeOffset = offset;
+    return true;
+}
+
+void MenuSettings::resetStats()
+{
+    commitCount = 0;
+    recordCount = 0;
+    eraseCount = 0;
+}
+
+#if defined(ESP32)
+#include <esp_partition.h>
+
+bool MenuPartitionStorage::begin()
+{
+    if (!partition)
+        partition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, label);
+    return partition;
+}
+
+int MenuPartitionStorage::sectorCount()
+{
+    return partition ? ((const esp_partition_t *)partition)->size / sectorSize() : 0;
+}
+
+bool MenuPartitionStorage::read(size_t offset, void *data, size_t length)
+{
+    return partition && esp_partition_read((const esp_partition_t *)partition, offset, data, length) == ESP_OK;
+}
+
+bool MenuPartitionStorage::write(size_t offset, const void *data, size_t length)
+{
+    return partition && esp_partition_write((const esp_partition_t *)partition, offset, data, length) == ESP_OK;
+}
+
+bool MenuPartitionStorage::erase(int sector)
+{
+    return partition && esp_partition_erase_range((const esp_partition_t *)partition, sector * sectorSize(), sectorSize()) == ESP_OK;
+}
+#endif
@@ -0,0 +1,95 @@
+#ifndef MENU_SETTINGS_H
+#define MENU_SETTINGS_H
+
+#include <Arduino.h>
+#include "MenuConfig.h"
+
+class MenuSystem;
+
+// Somewhere to keep the settings, laid out like NOR flash: sectorCount() sectors of sectorSize()
+// bytes, which read as 0xFF once erased and can then be written (a byte at a time, each byte once)
+// until they're erased again.  MenuPartitionStorage uses a flash partition on the ESP32; the host
+// tools use a file (extras/host/mock/HostFileStorage.h).
+class MenuStorage
+{
+public:
+    virtual bool begin() { return true; }
+    virtual size_t sectorSize() = 0;
+    virtual int sectorCount() = 0;
+    virtual bool read(size_t offset, void *data, size_t length) = 0;
+    virtual bool write(size_t offset, const void *data, size_t length) = 0;
+    virtual bool erase(int sector) = 0;
+};
+
+#if defined(ESP32)
+// A data partition in the ESP32's flash - add one to your partition table, e.g.
+//   menu, data, 0x99, , 16K
+// (4 sectors: the more there are, the longer each one lasts)
+class MenuPartitionStorage : public MenuStorage
+{
+protected:
+    const char *label;
+    const void *partition = nullptr; // (an esp_partition_t)
+
+public:
+    MenuPartitionStorage(const char *label = "menu") : label(label) {}
+    bool begin() override;
+    size_t sectorSize() override { return 4096; }
+    int sectorCount() override;
+    bool read(size_t offset, void *data, size_t length) override;
+    bool write(size_t offset, const void *data, size_t length) override;
+    bool erase(int sector) override;
+};
+#endif
+
+// A persisted value item (see persist() on the value items)
+struct MenuSetting
+{
+    uint16_t key;
+    uint8_t size;
+    MenuSystem *item;
+    void *value;
+    uint8_t saved[8]; // What the storage holds for it
+};
+
+// Keeps the values of the persisted items in a MenuStorage, so they survive a power cycle.
+// Edits aren't written as they're made: poll() notices a value which differs from the stored one
+// and writes it (with any others which have changed) once its editor returns focus, or after
+// commitDelay ms if the editor is still open.  Each write appends a small record (key, size,
+// checksum & value) to the active sector; when that's full the current values are copied to the
+// next sector, so the erases go round all of them.  begin() restores every value with one pass
+// through the active sector - the last record for each key wins, and a record cut short by a
+// power failure is ignored.
+class MenuSettings
+{
+protected:
+    MenuStorage *storage = nullptr;
+    MenuSetting settings[MENU_SYSTEM_MAX_SETTINGS];
+    int count = 0;
+    int sector = -1;         // The active sector (-1 = none yet)
+    uint32_t sequence = 0;   // ...and its place in the rotation
+    size_t writeOffset = 0;  // Where its next record goes
+    uint32_t commitDelay = 0;
+    bool dirty = false;
+    bool wasEditing = false;
+    unsigned long dirtySince = 0;
+    unsigned long commitCount = 0;
+    unsigned long recordCount = 0;
+    unsigned long eraseCount = 0;
+
+    size_t writeRecord(MenuSetting &setting, size_t offset);
+    bool append(MenuSetting &setting);
+    bool compact();
+
+public:
+    bool add(uint16_t key, MenuSystem *item, void *value, size_t size);
+    bool begin(MenuStorage *storage, uint32_t commitDelay);
+    void service(const MenuSystem *focus);
+    bool commit();
+    unsigned long commits() { return commitCount; }
+    unsigned long records() { return recordCount; }
+    unsigned long erases() { return eraseCount; }
+    void resetStats();
+};
+
+#endif // MENU_SETTINGS_H
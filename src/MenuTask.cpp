@@ -0,0 +1,115 @@
+#include "MenuTask.h"
+#include "DualEncoderMenuSystem.h"
+
+// Called before the render task starts (the mutex is never deleted, so locks can't outlive it)
+void MenuMutex::enable()
+{
+#if MENU_SYSTEM_RENDER_TASK
+    if (!handle)
+        handle = xSemaphoreCreateRecursiveMutex();
+#endif
+}
+
+bool MenuMutex::take()
+{
+#if MENU_SYSTEM_RENDER_TASK
+    return handle && xSemaphoreTakeRecursive(handle, portMAX_DELAY) == pdTRUE;
+#else
+    return false;
+#endif
+}
+
+void MenuMutex::give()
+{
+#if MENU_SYSTEM_RENDER_TASK
+    xSemaphoreGiveRecursive(handle);
+#endif
+}
+
+MenuLock::MenuLock() : MenuLock(MenuContext::active())
+{
+}
+
+MenuLock::MenuLock(MenuContext &context)
+{
+    if (context.mutex.take())
+        mutex = &context.mutex;
+}
+
+MenuLock::~MenuLock()
+{
+    if (mutex)
+        mutex->give();
+}
+
+void MenuRenderTask::run(void *param)
+{
+#if MENU_SYSTEM_RENDER_TASK
+    MenuRenderTask *task = (MenuRenderTask *)param;
+    uint32_t due = 0; // ms until the rest of a frame held back by the render limits can go
+
+    while (!task->stopping)
+    {
+        // Woken by poll() when input has changed the frame (otherwise, the timeout is just a safety net)
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(due ? due : task->idleMillis));
+        due = task->render(task->context, false);
+    }
+    task->render(task->context, true); // Anything drawn since our last pass
+    task->stopped = true;
+    vTaskDelete(nullptr);
+#endif
+}
+
+bool MenuRenderTask::start(uint32_t (*render)(MenuContext *context, bool all), MenuContext *context, MenuMutex &mutex, int core, int priority, uint32_t stackSize, uint32_t idleMillis)
+{
+#if MENU_SYSTEM_RENDER_TASK
+    if (handle || !render)
+        return false;
+    mutex.enable();
+    this->render = render;
+    this->context = context;
+    this->idleMillis = idleMillis;
+    stopping = false;
+    stopped = false;
+    if (xTaskCreatePinnedToCore(&MenuRenderTask::run, "MenuRender", stackSize, this, priority, &handle, core) != pdPASS)
+    {
+        handle = nullptr;
+        stopped = true;
+        return false;
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
+// Returns once the task has sent its last frame and gone
+void MenuRenderTask::stop()
+{
+#if MENU_SYSTEM_RENDER_TASK
+    if (!handle)
+        return;
+    stopping = true;
+    xTaskNotifyGive(handle);
+    while (!stopped)
+        delay(1);
+    handle = nullptr;
+#endif
+}
+
+bool MenuRenderTask::running()
+{
+#if MENU_SYSTEM_RENDER_TASK
+    return handle != nullptr;
+#else
+    return false;
+#endif
+}
+
+void MenuRenderTask::wake()
+{
+#if MENU_SYSTEM_RENDER_TASK
+    if (handle)
+        xTaskNotifyGive(handle);
+#endif
+}
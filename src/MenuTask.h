@@ -0,0 +1,68 @@
+#ifndef MENU_TASK_H
+#define MENU_TASK_H
+
+#include <Arduino.h>
+#include <atomic>
+#include "MenuConfig.h"
+
+#if MENU_SYSTEM_RENDER_TASK
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/semphr.h>
+#endif
+
+class MenuContext;
+
+// The recursive mutex behind MenuLock - one per MenuContext, created when its render task is first
+// started (recursive, as menu items call each other, and the sketch's MenuAction functions, with it held)
+class MenuMutex
+{
+protected:
+#if MENU_SYSTEM_RENDER_TASK
+    SemaphoreHandle_t handle = nullptr;
+#endif
+
+public:
+    void enable();
+    bool take();
+    void give();
+};
+
+// Hold one of these (e.g. { MenuLock lock; ... }) while using menu state from outside the menu
+// system's own callbacks - taking focus, or reading several values which must agree with each
+// other - once MenuSystem::startRenderTask() has been called.  Until then, it does nothing.
+// MenuLock lock(context) locks another MenuContext (the default is the one in use - see MenuContext::active()).
+class MenuLock
+{
+protected:
+    MenuMutex *mutex = nullptr;
+
+public:
+    MenuLock();
+    explicit MenuLock(MenuContext &context);
+    ~MenuLock();
+};
+
+// The task which sends a MenuContext's frame changes to its display (see MenuSystem::startRenderTask())
+class MenuRenderTask
+{
+protected:
+#if MENU_SYSTEM_RENDER_TASK
+    TaskHandle_t handle = nullptr;
+#endif
+    uint32_t (*render)(MenuContext *context, bool all) = nullptr;
+    MenuContext *context = nullptr;
+    uint32_t idleMillis = 100;
+    std::atomic<bool> stopping{false};
+    std::atomic<bool> stopped{true};
+
+    static void run(void *param);
+
+public:
+    bool start(uint32_t (*render)(MenuContext *context, bool all), MenuContext *context, MenuMutex &mutex, int core, int priority, uint32_t stackSize, uint32_t idleMillis);
+    void stop();
+    bool running();
+    void wake();
+};
+
+#endif // MENU_TASK_H
@@ -0,0 +1,153 @@
+#include "MenuTransport.h"
+
+void MenuLiquidCrystalTransport::begin(int cols, int rows)
+{
+    lcd->init();
+    lcd->backlight();
+}
+
+void MenuLiquidCrystalTransport::clear()
+{
+    lcd->clear();
+    MENU_STAT(busBytes += MENU_BUS_BYTES_PER_LCD_BYTE);
+}
+
+void MenuLiquidCrystalTransport::setCursor(uint8_t col, uint8_t row)
+{
+    lcd->setCursor(col, row);
+    MENU_STAT(busBytes += MENU_BUS_BYTES_PER_LCD_BYTE);
+}
+
+void MenuLiquidCrystalTransport::createChar(uint8_t slot, const uint8_t glyph[8])
+{
+    lcd->createChar(slot, const_cast<uint8_t *>(glyph));
+    MENU_STAT(busBytes += 9 * MENU_BUS_BYTES_PER_LCD_BYTE);
+}
+
+size_t MenuLiquidCrystalTransport::write(const uint8_t *buffer, size_t size)
+{
+    for (size_t i = 0; i < size; i++)
+        lcd->write(buffer[i]);
+    MENU_STAT(busBytes += size * MENU_BUS_BYTES_PER_LCD_BYTE);
+    return size;
+}
+
+// PCF8574 pins: P0 = RS, P1 = R/W (always write), P2 = E, P3 = backlight, P4-P7 = D4-D7
+#define PCF8574_RS 0x01
+#define PCF8574_E 0x04
+
+// Each transaction is one RS set-up byte, then 4 bytes per HD44780 byte
+#define PCF8574_BYTES_PER_TRANSACTION ((MENU_PCF8574_WIRE_BUFFER - 1) / 4)
+
+// Send bytes to the HD44780 (as characters if rs, otherwise as instructions), as few I2C transactions as the Wire buffer allows
+void MenuPCF8574Transport::send(const uint8_t *bytes, size_t count, uint8_t rs)
+{
+    while (count)
+    {
+        size_t n = min(count, (size_t)PCF8574_BYTES_PER_TRANSACTION);
+
+        wire->beginTransmission(address);
+        wire->write(rs | backlight); // RS settles before the first E pulse
+        for (size_t i = 0; i < n; i++)
+        {
+            uint8_t high = (bytes[i] & 0xF0) | rs | backlight;
+            uint8_t low = (bytes[i] << 4) | rs | backlight;
+
+            // The HD44780 latches each nibble as E falls
+            wire->write(high | PCF8574_E);
+            wire->write(high);
+            wire->write(low | PCF8574_E);
+            wire->write(low);
+        }
+        wire->endTransmission();
+        MENU_STAT(busBytes += 2 + n * 4);
+        bytes += n;
+        count -= n;
+    }
+}
+
+void MenuPCF8574Transport::command(uint8_t value)
+{
+    send(&value, 1, 0);
+}
+
+// One nibble with the HD44780 still in 8-bit mode (only D4-D7 are connected), used while initialising it
+void MenuPCF8574Transport::initNibble(uint8_t nibble)
+{
+    uint8_t data = (nibble << 4) | backlight;
+
+    wire->beginTransmission(address);
+    wire->write(data);
+    wire->write(data | PCF8574_E);
+    wire->write(data);
+    wire->endTransmission();
+    MENU_STAT(busBytes += 4);
+}
+
+void MenuPCF8574Transport::begin(int cols, int rows)
+{
+    this->cols = cols;
+    this->rows = rows;
+
+    // HD44780 4-bit initialisation by instruction (datasheet figure 24) - works whatever state it was left in
+    delay(50);
+    initNibble(0x03);
+    delayMicroseconds(4500);
+    initNibble(0x03);
+    delayMicroseconds(4500);
+    initNibble(0x03);
+    delayMicroseconds(150);
+    initNibble(0x02);
+    command(rows > 1 ? 0x28 : 0x20); // 4-bit, 2 (or 1) line, 5x8 font
+    command(0x0C);                   // Display on, no cursor, no blink
+    clear();
+    command(0x06); // Left to right, no shift
+}
+
+void MenuPCF8574Transport::clear()
+{
+    command(0x01);
+    delayMicroseconds(2000); // Clear takes the HD44780 1.52ms
+}
+
+void MenuPCF8574Transport::setCursor(uint8_t col, uint8_t row)
+{
+    // Rows 2 & 3 follow on from rows 0 & 1 in DDRAM
+    static const uint8_t rowOffsets[] = {0x00, 0x40, 0x00, 0x40};
+
+    if (row >= rows)
+        row = rows - 1;
+    command(0x80 | (col + rowOffsets[row & 3] + (row & 2 ? cols : 0)));
+}
+
+void MenuPCF8574Transport::createChar(uint8_t slot, const uint8_t glyph[8])
+{
+    command(0x40 | ((slot & 0x07) << 3));
+    send(glyph, 8, PCF8574_RS);
+}
+
+size_t MenuPCF8574Transport::write(const uint8_t *buffer, size_t size)
+{
+    send(buffer, size, PCF8574_RS);
+    return size;
+}
+
+// What send() costs: per transaction, the address & RS set-up bytes, plus 4 per HD44780 byte
+unsigned int MenuPCF8574Transport::cursorBytes()
+{
+    return runBytes(1);
+}
+
+unsigned int MenuPCF8574Transport::runBytes(size_t length)
+{
+    return 2 * ((length + PCF8574_BYTES_PER_TRANSACTION - 1) / PCF8574_BYTES_PER_TRANSACTION) + 4 * length;
+}
+
+void MenuPCF8574Transport::setBacklight(bool on)
+{
+    backlight = on ? 0x08 : 0x00;
+    wire->beginTransmission(address);
+    wire->write(backlight);
+    wire->endTransmission();
+    MENU_STAT(busBytes += 2);
+}
@@ -0,0 +1,93 @@
+#ifndef MENU_TRANSPORT_H
+#define MENU_TRANSPORT_H
+
+#include <Arduino.h>
+#include <Wire.h>
+#include <LiquidCrystal_I2C.h>
+#include "MenuConfig.h"
+
+// How the menu system talks to the display.  Pass MenuSystem::begin() a LiquidCrystal_I2C (which is
+// wrapped in a MenuLiquidCrystalTransport for you) or any other transport, e.g. MenuPCF8574Transport.
+// Transports are Print-able, so a MenuAction can draw with them too (lcd->setCursor(), lcd->print(), ...).
+// LiquidCrystal_I2C sends each HD44780 byte as 6 single-byte PCF8574 transactions (plus address byte)
+#define MENU_BUS_BYTES_PER_LCD_BYTE 12
+
+class MenuDisplayTransport : public Print
+{
+public:
+#if MENU_SYSTEM_STATS
+    unsigned long busBytes = 0; // I2C bytes sent (including address bytes) - see MenuSystem::getStats()
+#endif
+
+    virtual void begin(int cols, int rows) = 0; // Initialise the display: cleared, display & backlight on
+    virtual void clear() = 0;
+    virtual void setCursor(uint8_t col, uint8_t row) = 0;
+    virtual void createChar(uint8_t slot, const uint8_t glyph[8]) = 0;
+    size_t write(uint8_t c) override { return write(&c, 1); }
+    size_t write(const uint8_t *buffer, size_t size) override = 0; // A run of characters, from the cursor
+    using Print::write;
+
+    // Roughly how many bus bytes a setCursor() / write() of a run costs, for MenuSystem::setRenderLimits()
+    // (the defaults are LiquidCrystal_I2C's)
+    virtual unsigned int cursorBytes() { return MENU_BUS_BYTES_PER_LCD_BYTE; }
+    virtual unsigned int runBytes(size_t length) { return length * MENU_BUS_BYTES_PER_LCD_BYTE; }
+};
+
+// The LiquidCrystal_I2C library, as used by the sketch
+class MenuLiquidCrystalTransport : public MenuDisplayTransport
+{
+protected:
+    LiquidCrystal_I2C *lcd;
+
+public:
+    MenuLiquidCrystalTransport(LiquidCrystal_I2C *lcd = nullptr) : lcd(lcd) {}
+    void begin(int cols, int rows) override;
+    void clear() override;
+    void setCursor(uint8_t col, uint8_t row) override;
+    void createChar(uint8_t slot, const uint8_t glyph[8]) override;
+    size_t write(const uint8_t *buffer, size_t size) override;
+    using MenuDisplayTransport::write;
+};
+
+// Bytes the Wire library can send in one transaction (the address byte isn't included)
+#ifndef MENU_PCF8574_WIRE_BUFFER
+#if defined(I2C_BUFFER_LENGTH)
+#define MENU_PCF8574_WIRE_BUFFER I2C_BUFFER_LENGTH // ESP32 (128)
+#elif defined(BUFFER_LENGTH)
+#define MENU_PCF8574_WIRE_BUFFER BUFFER_LENGTH // AVR (32)
+#else
+#define MENU_PCF8574_WIRE_BUFFER 32
+#endif
+#endif
+
+// Drives an HD44780 through a PCF8574 backpack directly, encoding a whole run of characters (enable
+// strobes and all) into a single buffered I2C write, rather than LiquidCrystal_I2C's 6 separate
+// transactions per character.  One byte sets up RS, then each nibble is 2 bytes (E high, E low).
+// The bus itself paces the HD44780 (37us per instruction): fine at up to 400kHz.
+class MenuPCF8574Transport : public MenuDisplayTransport
+{
+protected:
+    TwoWire *wire;
+    uint8_t address;
+    uint8_t backlight = 0x08;
+    uint8_t cols = 16;
+    uint8_t rows = 2;
+
+    void send(const uint8_t *bytes, size_t count, uint8_t rs);
+    void command(uint8_t value);
+    void initNibble(uint8_t nibble);
+
+public:
+    MenuPCF8574Transport(uint8_t address = 0x27, TwoWire &wire = Wire) : wire(&wire), address(address) {}
+    void begin(int cols, int rows) override;
+    void clear() override;
+    void setCursor(uint8_t col, uint8_t row) override;
+    void createChar(uint8_t slot, const uint8_t glyph[8]) override;
+    size_t write(const uint8_t *buffer, size_t size) override;
+    using MenuDisplayTransport::write;
+    unsigned int cursorBytes() override;
+    unsigned int runBytes(size_t length) override;
+    void setBacklight(bool on);
+};
+
+#endif // MENU_TRANSPORT_H
@@ -0,0 +1,109 @@
+#ifndef MENU_TREE_H
+#define MENU_TREE_H
+
+#include <Arduino.h>
+#include "MenuConfig.h"
+
+// Compile-time menu definitions.  Labels and lists declared with these types are checked
+// by the compiler (width, item count, no null entries) and, being constant, are placed in
+// flash.  Menu items constructed from them are constant-initialised: no heap allocation
+// and no scanning of null-terminated lists at boot.
+//
+//     MenuLongValue cfgVolume(MenuLabel("Set Volume"), MenuLabel("%"), 0, 100, 10, 1, &volume);
+//     MENU_LIST(brightnessLevels, "Low", "Medium", "High");
+//     MenuDropDownListValue cfgBrightness(MenuLabel("Set Brightness"), brightnessLevels, &brightness);
+//     MENU_ITEMS(configItems, &cfgBrightness, &cfgVolume);
+//     Menu cfgMnu(MenuLabel("Configuration"), configItems);
+//
+// (The items first, then the list of them, then the menu - as in examples/BasicUsage.)
+
+class MenuSystem;
+
+// (MENU_LABEL_WIDTH & MENU_OPTION_WIDTH are in MenuConfig.h)
+static_assert(MENU_LABEL_WIDTH <= MENU_SYSTEM_MAX_COLS - 2, "MENU_LABEL_WIDTH must leave room for the selection marker & type indicator");
+static_assert(MENU_OPTION_WIDTH <= MENU_LABEL_WIDTH, "MENU_OPTION_WIDTH can't be more than MENU_LABEL_WIDTH");
+
+// A string and its length.  Text is clipped to the available space when it is drawn, so
+// nothing needs to be copied (or truncated) when a menu item is constructed.
+struct MenuTextView
+{
+    const char *text;
+    uint8_t length;
+
+    constexpr MenuTextView(const char *text = "", uint8_t length = 0) : text(text), length(length) {}
+    static MenuTextView of(const char *text, const char *fallback = "");
+};
+
+// A string literal, checked at compile time to be no wider than Width characters.  Only the pointer
+// is kept, so the text must last as long as the item - a literal (or a constant array at namespace
+// scope), never a buffer: a writable array won't compile, and a const array on the stack isn't
+// supported (use the items' const char * constructors for text made up at run time).
+template <size_t Width>
+struct MenuText : public MenuTextView
+{
+    template <size_t N>
+    constexpr MenuText(const char (&text)[N]) : MenuTextView(text, N - 1)
+    {
+        static_assert(N - 1 <= Width, "Menu text is too wide for the display (see MENU_LABEL_WIDTH & MENU_OPTION_WIDTH in MenuConfig.h)");
+    }
+    template <size_t N>
+    MenuText(char (&text)[N]) = delete; // A buffer (its contents can change, or be gone) - not a literal
+};
+
+typedef MenuText<MENU_LABEL_WIDTH> MenuLabel;
+typedef MenuText<MENU_OPTION_WIDTH> MenuOption;
+
+// A fixed-size list of menu items (see MENU_ITEMS) - no null terminator needed
+struct MenuItemList
+{
+    MenuSystem *const *items;
+    int count;
+
+    template <size_t N>
+    constexpr MenuItemList(MenuSystem *const (&items)[N]) : items(items), count(N)
+    {
+        static_assert(N > 0, "A Menu needs at least one item");
+    }
+};
+
+// A fixed-size list of strings (see MENU_LIST) - no null terminator needed
+struct MenuStringList
+{
+    const char *const *items;
+    int count;
+
+    template <size_t N>
+    constexpr MenuStringList(const char *const (&items)[N]) : items(items), count(N)
+    {
+        static_assert(N > 0, "A list needs at least one item");
+    }
+};
+
+constexpr bool menuTextFits(const char *text, size_t width)
+{
+    return text && (*text == 0 || (width > 0 && menuTextFits(text + 1, width - 1)));
+}
+
+constexpr bool menuTextsFit(const char *const *texts, size_t count, size_t width)
+{
+    return count == 0 || (menuTextFits(texts[0], width) && menuTextsFit(texts + 1, count - 1, width));
+}
+
+constexpr bool menuItemsValid(MenuSystem *const *items, size_t count)
+{
+    return count == 0 || (items[0] != nullptr && menuItemsValid(items + 1, count - 1));
+}
+
+// Declares a constant (flash-resident) list of menu item pointers, e.g. MENU_ITEMS(mainItems, &mmRun, &mmSpeed);
+#define MENU_ITEMS(name, ...)                                                  \
+    constexpr MenuSystem *const name[] = {__VA_ARGS__};                        \
+    static_assert(menuItemsValid(name, sizeof(name) / sizeof(name[0])),        \
+                  "MENU_ITEMS(" #name ") contains a null item - lists declared this way are not null-terminated")
+
+// Declares a constant (flash-resident) list of strings, e.g. MENU_LIST(modes, "Automatic", "Manual");
+#define MENU_LIST(name, ...)                                                                 \
+    constexpr const char *const name[] = {__VA_ARGS__};                                      \
+    static_assert(menuTextsFit(name, sizeof(name) / sizeof(name[0]), MENU_LABEL_WIDTH),      \
+                  "MENU_LIST(" #name ") contains a null or over-long item - lists declared this way are not null-terminated")
+
+#endif // MENU_TREE_H